@@ -1,13 +1,13 @@
 # To help simplify including Clique in external projects
 include @CMAKE_INSTALL_PREFIX@/conf/elemvariables
 
-CLIQ_COMPILE_FLAGS = ${ELEM_COMPILE_FLAGS}
+CLIQ_COMPILE_FLAGS = ${ELEM_COMPILE_FLAGS} @OpenMP_CXX_FLAGS@
 CLIQ_LINK_FLAGS = ${ELEM_LINK_FLAGS}
 
 HAVE_PARMETIS = @HAVE_PARMETIS@
 ifeq (${HAVE_PARMETIS},TRUE)
   CLIQ_LIBS = -lclique -lparmetis-addons -lmetis-addons -lparmetis -lmetis \
-              ${ELEM_LIBS}
+              ${ELEM_LIBS} @CMAKE_THREAD_LIBS_INIT@
 else
-  CLIQ_LIBS = -lclique ${ELEM_LIBS}
+  CLIQ_LIBS = -lclique ${ELEM_LIBS} @CMAKE_THREAD_LIBS_INIT@
 endif
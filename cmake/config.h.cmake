@@ -17,5 +17,6 @@
 #cmakedefine USE_CUSTOM_ALLTOALLV
 #cmakedefine BARRIER_IN_ALLTOALLV
 #cmakedefine HAVE_PARMETIS
+#cmakedefine HAVE_OPENMP
 
 #endif /* CLIQUE_CONFIG_H */
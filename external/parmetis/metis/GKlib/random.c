@@ -60,10 +60,11 @@ GK_MKRANDOM(gk_idx, size_t, gk_idx_t)
 #define LM 0x7FFFFFFFULL /* Least significant 31 bits */
 
 
-/* The array for the state vector */
-static uint64_t mt[NN]; 
+/* The array for the state vector (which is thread-local so that concurrent
+   calls which each reseed the generator are independent and reproducible) */
+static metis__thread uint64_t mt[NN]; 
 /* mti==NN+1 means mt[NN] is not initialized */
-static int mti=NN+1; 
+static metis__thread int mti=NN+1; 
 #endif /* USE_GKRAND */
 
 /* initializes mt[NN] with a seed */
@@ -13,17 +13,35 @@
 #define CLIQUE_HPP
 
 #include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <limits>
 #include <map>
+#include <mutex>
 #include <set>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "El.hpp"
 #include "clique/config.h"
+#ifdef HAVE_OPENMP
+# include <omp.h>
+#endif
 
 // The core of the library
 // =======================
 
 #include "clique/core/environment/decl.hpp"
 #include "clique/core/environment/impl.hpp"
+#include "clique/core/comm_plan/decl.hpp"
+#include "clique/core/comm_plan/impl.hpp"
 
 // Data-structure declarations 
 namespace cliq { 
@@ -60,6 +78,7 @@ namespace cliq {
 #include "clique/symbolic/dist_symm_elim_tree.hpp"
 #include "clique/symbolic/dist_symm_info.hpp"
 #include "clique/symbolic/symm_analysis.hpp"
+#include "clique/symbolic/amalgamate.hpp"
 #include "clique/symbolic/nested_dissection.hpp"
 #include "clique/symbolic/natural_nested_dissection.hpp"
 
@@ -72,7 +91,14 @@ namespace cliq {
 #include "clique/numeric/dist_nodal_matrix/decl.hpp"
 #include "clique/numeric/dist_nodal_multi_vec/impl.hpp"
 #include "clique/numeric/dist_nodal_matrix/impl.hpp"
-
+#include "clique/numeric/subtree_mask.hpp"
+
+#include "clique/numeric/front_store/decl.hpp"
+#include "clique/numeric/front_store/impl.hpp"
+#include "clique/numeric/solve_arena/decl.hpp"
+#include "clique/numeric/solve_arena/impl.hpp"
+#include "clique/numeric/update_arena/decl.hpp"
+#include "clique/numeric/update_arena/impl.hpp"
 #include "clique/numeric/dist_symm_front_tree/decl.hpp"
 #include "clique/numeric/dist_symm_front_tree/impl.hpp"
 #include "clique/numeric/change_front_type.hpp"
@@ -81,6 +107,9 @@ namespace cliq {
 #include "clique/numeric/lower_solve.hpp"
 #include "clique/numeric/diagonal_solve.hpp"
 #include "clique/numeric/solve.hpp"
+#include "clique/numeric/refined_solve.hpp"
+#include "clique/numeric/solve_session/decl.hpp"
+#include "clique/numeric/solve_session/impl.hpp"
 #include "clique/numeric/lower_multiply.hpp"
 
 // Input/Output
@@ -88,5 +117,7 @@ namespace cliq {
 
 #include "clique/io/Print.hpp"
 #include "clique/io/Display.hpp"
+#include "clique/io/SaveAnalysis.hpp"
+#include "clique/io/SaveFactorization.hpp"
 
 #endif // ifndef CLIQUE_HPP
@@ -0,0 +1,96 @@
+/*
+   Copyright (c) 2009-2014, Jack Poulson, Lexing Ying,
+   The University of Texas at Austin, Stanford University, and the
+   Georgia Insitute of Technology.
+   All rights reserved.
+ 
+   This file is part of Clique and is under the BSD 2-Clause License, 
+   which can be found in the LICENSE file in the root directory, or at 
+   http://opensource.org/licenses/BSD-2-Clause
+*/
+#pragma once
+#ifndef CLIQ_CORE_COMMPLAN_DECL_HPP
+#define CLIQ_CORE_COMMPLAN_DECL_HPP
+
+namespace cliq {
+
+// A sparse all-to-all exchange whose pattern is fixed when the plan is set up.
+// The plan owns its send and receive buffers and binds one persistent MPI
+// request to each nonempty message, so that repeating the exchange (e.g., for
+// every refactorization or solve) only requires packing the send buffer,
+// calling Exchange (or StartRecvs/StartSends and the Wait* routines), and
+// unpacking the receive buffer.
+//
+// The counts and displacements are in units of blocks of 'blocksize' entries
+// of type T, so that a multi-vector with a fixed number of columns can be
+// exchanged row-by-row.
+class CommPlan
+{
+public:
+    CommPlan();
+    CommPlan( const CommPlan& plan );
+    ~CommPlan();
+
+    const CommPlan& operator=( const CommPlan& plan );
+
+    template<typename T>
+    void Setup
+    ( const std::vector<int>& sendCounts, const std::vector<int>& recvCounts,
+      mpi::Comm comm, int blocksize=1, int tag=0 );
+    void Empty();
+
+    // Whether or not the plan was set up over the given communicator for
+    // blocks of 'blocksize' entries of type T. Since a freed communicator's
+    // handle can be reused, the owner of a plan must empty it before freeing
+    // the communicator which it was set up over.
+    template<typename T>
+    bool Ready( mpi::Comm comm, int blocksize=1 ) const;
+
+    const std::vector<int>& SendCounts() const;
+    const std::vector<int>& SendDispls() const;
+    const std::vector<int>& RecvCounts() const;
+    const std::vector<int>& RecvDispls() const;
+    int SendSize() const;
+    int RecvSize() const;
+
+    // Pointers to the beginning of the portion of each buffer which is
+    // exchanged with process 'proc'
+    template<typename T>
+    T* SendBuffer( int proc=0 );
+    template<typename T>
+    T* RecvBuffer( int proc=0 );
+    template<typename T>
+    const T* LockedRecvBuffer( int proc=0 ) const;
+
+    void StartRecvs();
+    void StartSends();
+    // Returns the rank of a process whose message was received, or -1 if all
+    // of the started receives have already been returned
+    int WaitAnyRecv();
+    void WaitRecvs();
+    void WaitSends();
+
+    // StartRecvs, StartSends, WaitRecvs, and WaitSends
+    void Exchange();
+
+private:
+    bool ready_;
+    mpi::Comm comm_;
+    int tag_;
+    std::size_t blockBytes_;
+    MPI_Datatype blockType_;
+
+    std::vector<int> sendCounts_, sendDispls_, recvCounts_, recvDispls_;
+    std::vector<byte> sendBuffer_, recvBuffer_;
+
+    std::vector<mpi::Request> sendRequests_, recvRequests_;
+    std::vector<int> recvProcs_;
+
+    void SetupBlocks
+    ( const std::vector<int>& sendCounts, const std::vector<int>& recvCounts,
+      mpi::Comm comm, std::size_t blockBytes, int tag );
+};
+
+} // namespace cliq
+
+#endif // ifndef CLIQ_CORE_COMMPLAN_DECL_HPP
@@ -0,0 +1,283 @@
+/*
+   Copyright (c) 2009-2014, Jack Poulson, Lexing Ying,
+   The University of Texas at Austin, Stanford University, and the
+   Georgia Insitute of Technology.
+   All rights reserved.
+ 
+   This file is part of Clique and is under the BSD 2-Clause License, 
+   which can be found in the LICENSE file in the root directory, or at 
+   http://opensource.org/licenses/BSD-2-Clause
+*/
+#pragma once
+#ifndef CLIQ_CORE_COMMPLAN_IMPL_HPP
+#define CLIQ_CORE_COMMPLAN_IMPL_HPP
+
+namespace cliq {
+
+inline
+CommPlan::CommPlan()
+: ready_(false), comm_(mpi::COMM_WORLD), tag_(0), blockBytes_(0)
+{ }
+
+inline
+CommPlan::CommPlan( const CommPlan& plan )
+: ready_(false), comm_(mpi::COMM_WORLD), tag_(0), blockBytes_(0)
+{ *this = plan; }
+
+inline
+CommPlan::~CommPlan()
+{
+    int finalized;
+    MPI_Finalized( &finalized );
+    if( !finalized )
+        Empty();
+}
+
+inline const CommPlan&
+CommPlan::operator=( const CommPlan& plan )
+{
+    DEBUG_ONLY(CallStackEntry cse("CommPlan::operator="))
+    if( &plan == this )
+        return *this;
+    // The persistent requests are bound to the buffers, so they are rebuilt
+    // rather than copied
+    Empty();
+    if( plan.ready_ )
+        SetupBlocks
+        ( plan.sendCounts_, plan.recvCounts_, plan.comm_, plan.blockBytes_,
+          plan.tag_ );
+    return *this;
+}
+
+template<typename T>
+inline void
+CommPlan::Setup
+( const std::vector<int>& sendCounts, const std::vector<int>& recvCounts,
+  mpi::Comm comm, int blocksize, int tag )
+{
+    DEBUG_ONLY(CallStackEntry cse("CommPlan::Setup"))
+    SetupBlocks( sendCounts, recvCounts, comm, blocksize*sizeof(T), tag );
+}
+
+inline void
+CommPlan::SetupBlocks
+( const std::vector<int>& sendCounts, const std::vector<int>& recvCounts,
+  mpi::Comm comm, std::size_t blockBytes, int tag )
+{
+    DEBUG_ONLY(
+        CallStackEntry cse("CommPlan::SetupBlocks");
+        if( int(sendCounts.size()) != mpi::Size(comm) ||
+            int(recvCounts.size()) != mpi::Size(comm) )
+            LogicError("Send and recv counts must be of the comm size");
+    )
+    Empty();
+    comm_ = comm;
+    tag_ = tag;
+    blockBytes_ = blockBytes;
+    MPI_Type_contiguous( blockBytes, MPI_BYTE, &blockType_ );
+    MPI_Type_commit( &blockType_ );
+
+    const int commSize = sendCounts.size();
+    sendCounts_ = sendCounts;
+    recvCounts_ = recvCounts;
+    sendDispls_.resize( commSize );
+    recvDispls_.resize( commSize );
+    int sendSize=0, recvSize=0;
+    for( int proc=0; proc<commSize; ++proc )
+    {
+        sendDispls_[proc] = sendSize;
+        recvDispls_[proc] = recvSize;
+        sendSize += sendCounts[proc];
+        recvSize += recvCounts[proc];
+    }
+    sendBuffer_.resize( sendSize*blockBytes );
+    recvBuffer_.resize( recvSize*blockBytes );
+
+    // Bind a persistent request to each nonempty message
+    for( int proc=0; proc<commSize; ++proc )
+    {
+        if( recvCounts[proc] != 0 )
+        {
+            recvRequests_.push_back( mpi::Request() );
+            recvProcs_.push_back( proc );
+            MPI_Recv_init
+            ( &recvBuffer_[recvDispls_[proc]*blockBytes], recvCounts[proc],
+              blockType_, proc, tag, comm.comm, &recvRequests_.back() );
+        }
+    }
+    for( int proc=0; proc<commSize; ++proc )
+    {
+        if( sendCounts[proc] != 0 )
+        {
+            sendRequests_.push_back( mpi::Request() );
+            MPI_Send_init
+            ( &sendBuffer_[sendDispls_[proc]*blockBytes], sendCounts[proc],
+              blockType_, proc, tag, comm.comm, &sendRequests_.back() );
+        }
+    }
+    ready_ = true;
+}
+
+inline void
+CommPlan::Empty()
+{
+    if( !ready_ )
+        return;
+    const int numSends = sendRequests_.size();
+    const int numRecvs = recvRequests_.size();
+    for( int k=0; k<numSends; ++k )
+        MPI_Request_free( &sendRequests_[k] );
+    for( int k=0; k<numRecvs; ++k )
+        MPI_Request_free( &recvRequests_[k] );
+    MPI_Type_free( &blockType_ );
+
+    SwapClear( sendCounts_ );
+    SwapClear( sendDispls_ );
+    SwapClear( recvCounts_ );
+    SwapClear( recvDispls_ );
+    SwapClear( sendBuffer_ );
+    SwapClear( recvBuffer_ );
+    SwapClear( sendRequests_ );
+    SwapClear( recvRequests_ );
+    SwapClear( recvProcs_ );
+    blockBytes_ = 0;
+    ready_ = false;
+}
+
+template<typename T>
+inline bool
+CommPlan::Ready( mpi::Comm comm, int blocksize ) const
+{ return ready_ && blockBytes_ == blocksize*sizeof(T) && comm_ == comm; }
+
+inline const std::vector<int>&
+CommPlan::SendCounts() const
+{ return sendCounts_; }
+
+inline const std::vector<int>&
+CommPlan::SendDispls() const
+{ return sendDispls_; }
+
+inline const std::vector<int>&
+CommPlan::RecvCounts() const
+{ return recvCounts_; }
+
+inline const std::vector<int>&
+CommPlan::RecvDispls() const
+{ return recvDispls_; }
+
+inline int
+CommPlan::SendSize() const
+{ return ( ready_ ? sendBuffer_.size()/blockBytes_ : 0 ); }
+
+inline int
+CommPlan::RecvSize() const
+{ return ( ready_ ? recvBuffer_.size()/blockBytes_ : 0 ); }
+
+template<typename T>
+inline T*
+CommPlan::SendBuffer( int proc )
+{
+    DEBUG_ONLY(
+        CallStackEntry cse("CommPlan::SendBuffer");
+        if( !ready_ )
+            LogicError("Plan was not set up");
+    )
+    if( sendBuffer_.size() == 0 )
+        return 0;
+    return reinterpret_cast<T*>(&sendBuffer_[sendDispls_[proc]*blockBytes_]);
+}
+
+template<typename T>
+inline T*
+CommPlan::RecvBuffer( int proc )
+{
+    DEBUG_ONLY(
+        CallStackEntry cse("CommPlan::RecvBuffer");
+        if( !ready_ )
+            LogicError("Plan was not set up");
+    )
+    if( recvBuffer_.size() == 0 )
+        return 0;
+    return reinterpret_cast<T*>(&recvBuffer_[recvDispls_[proc]*blockBytes_]);
+}
+
+template<typename T>
+inline const T*
+CommPlan::LockedRecvBuffer( int proc ) const
+{
+    DEBUG_ONLY(
+        CallStackEntry cse("CommPlan::LockedRecvBuffer");
+        if( !ready_ )
+            LogicError("Plan was not set up");
+    )
+    if( recvBuffer_.size() == 0 )
+        return 0;
+    return reinterpret_cast<const T*>
+           (&recvBuffer_[recvDispls_[proc]*blockBytes_]);
+}
+
+inline void
+CommPlan::StartRecvs()
+{
+    DEBUG_ONLY(CallStackEntry cse("CommPlan::StartRecvs"))
+    if( recvRequests_.size() != 0 )
+        MPI_Startall( recvRequests_.size(), &recvRequests_[0] );
+}
+
+inline void
+CommPlan::StartSends()
+{
+    DEBUG_ONLY(CallStackEntry cse("CommPlan::StartSends"))
+#ifdef BARRIER_IN_ALLTOALLV
+    // This should help ensure that recvs are posted before the sends
+    mpi::Barrier( comm_ );
+#endif
+    if( sendRequests_.size() != 0 )
+        MPI_Startall( sendRequests_.size(), &sendRequests_[0] );
+}
+
+inline int
+CommPlan::WaitAnyRecv()
+{
+    DEBUG_ONLY(CallStackEntry cse("CommPlan::WaitAnyRecv"))
+    if( recvRequests_.size() == 0 )
+        return -1;
+    int index;
+    MPI_Waitany
+    ( recvRequests_.size(), &recvRequests_[0], &index, MPI_STATUS_IGNORE );
+    // Completed persistent requests become inactive, and waiting on a set of
+    // inactive requests returns MPI_UNDEFINED
+    return ( index == MPI_UNDEFINED ? -1 : recvProcs_[index] );
+}
+
+inline void
+CommPlan::WaitRecvs()
+{
+    DEBUG_ONLY(CallStackEntry cse("CommPlan::WaitRecvs"))
+    if( recvRequests_.size() != 0 )
+        MPI_Waitall
+        ( recvRequests_.size(), &recvRequests_[0], MPI_STATUSES_IGNORE );
+}
+
+inline void
+CommPlan::WaitSends()
+{
+    DEBUG_ONLY(CallStackEntry cse("CommPlan::WaitSends"))
+    if( sendRequests_.size() != 0 )
+        MPI_Waitall
+        ( sendRequests_.size(), &sendRequests_[0], MPI_STATUSES_IGNORE );
+}
+
+inline void
+CommPlan::Exchange()
+{
+    DEBUG_ONLY(CallStackEntry cse("CommPlan::Exchange"))
+    StartRecvs();
+    StartSends();
+    WaitRecvs();
+    WaitSends();
+}
+
+} // namespace cliq
+
+#endif // ifndef CLIQ_CORE_COMMPLAN_IMPL_HPP
@@ -26,6 +26,10 @@ public:
     DistGraph( mpi::Comm comm );
     DistGraph( int numVertices, mpi::Comm comm );
     DistGraph( int numSources, int numTargets, mpi::Comm comm );
+    // Adopt local compressed-row data (see AssembleFromCSR)
+    DistGraph
+    ( int numSources, int numTargets, mpi::Comm comm,
+      std::vector<int> localEdgeOffsets, std::vector<int> targets );
     DistGraph( const Graph& graph );
     DistGraph( const DistGraph& graph );
     ~DistGraph();
@@ -50,6 +54,14 @@ public:
     void Insert( int source, int target );
     int Capacity() const;
 
+    // Replace the local edges with a compressed-row structure, where the 
+    // targets of local source s are targets[localEdgeOffsets[s]] through 
+    // targets[localEdgeOffsets[s+1]-1]. Both arrays are adopted (pass them 
+    // with std::move to avoid any copies), and the sort is skipped if the 
+    // targets of each source are already strictly increasing.
+    void AssembleFromCSR
+    ( std::vector<int> localEdgeOffsets, std::vector<int> targets );
+
     // Local data
     int NumLocalEdges() const;
     int Source( int localEdge ) const;
@@ -83,9 +95,8 @@ private:
     bool assembling_, sorted_;
     std::vector<int> localEdgeOffsets_;
     void ComputeLocalEdgeOffsets();
-
-    static bool ComparePairs
-    ( const std::pair<int,int>& a, const std::pair<int,int>& b );
+    bool AdoptLocalCSR
+    ( std::vector<int>& localEdgeOffsets, std::vector<int>& targets );
 
     void EnsureNotAssembling() const;
     void EnsureConsistentSizes() const;
@@ -34,6 +34,17 @@ DistGraph::DistGraph( int numSources, int numTargets, mpi::Comm comm )
 : numSources_(numSources), numTargets_(numTargets), comm_(mpi::COMM_WORLD)
 { SetComm( comm ); }
 
+inline
+DistGraph::DistGraph
+( int numSources, int numTargets, mpi::Comm comm,
+  std::vector<int> localEdgeOffsets, std::vector<int> targets )
+: numSources_(numSources), numTargets_(numTargets), comm_(mpi::COMM_WORLD)
+{
+    DEBUG_ONLY(CallStackEntry cse("DistGraph::DistGraph"))
+    SetComm( comm );
+    AssembleFromCSR( std::move(localEdgeOffsets), std::move(targets) );
+}
+
 inline
 DistGraph::DistGraph( const Graph& graph )
 {
@@ -228,11 +239,6 @@ DistGraph::operator=( const DistGraph& graph )
     return *this;
 }
 
-inline bool
-DistGraph::ComparePairs
-( const std::pair<int,int>& a, const std::pair<int,int>& b )
-{ return a.first < b.first || (a.first == b.first && a.second < b.second); }
-
 inline void
 DistGraph::StartAssembly()
 {
@@ -249,35 +255,87 @@ DistGraph::StopAssembly()
         LogicError("Cannot stop assembly without starting");
     assembling_ = false;
 
-    // Ensure that the connection pairs are sorted
-    if( !sorted_ )
+    // Ensure that the connection pairs are sorted and unique
+    SortAndCombinePairs
+    ( sources_, targets_, firstLocalSource_, numLocalSources_, numTargets_,
+      sorted_ );
+    sorted_ = true;
+
+    ComputeLocalEdgeOffsets();
+}
+
+// Returns whether or not the targets of each source were strictly increasing
+inline bool
+DistGraph::AdoptLocalCSR
+( std::vector<int>& localEdgeOffsets, std::vector<int>& targets )
+{
+    DEBUG_ONLY(CallStackEntry cse("DistGraph::AdoptLocalCSR"))
+    EnsureNotAssembling();
+    const int numLocalEdges = targets.size();
+    if( int(localEdgeOffsets.size()) != numLocalSources_+1 )
+        LogicError
+        ("Expected ",numLocalSources_+1," edge offsets but received ",
+         localEdgeOffsets.size());
+    if( localEdgeOffsets[0] != 0 || 
+        localEdgeOffsets[numLocalSources_] != numLocalEdges )
+        LogicError("Edge offsets did not span the targets");
+    for( int s=0; s<numLocalSources_; ++s )
+        if( localEdgeOffsets[s+1] < localEdgeOffsets[s] )
+            LogicError("Edge offsets were not nondecreasing");
+
+    // Check the targets before anything is adopted so that an invalid 
+    // structure leaves the graph untouched
+    bool sorted=true, inBounds=true;
+#ifdef HAVE_OPENMP
+    #pragma omp parallel for reduction(&&:sorted,inBounds)
+#endif
+    for( int s=0; s<numLocalSources_; ++s )
     {
-        const int numLocalEdges = sources_.size();
-        std::vector<std::pair<int,int>> pairs( numLocalEdges );
-        for( int e=0; e<numLocalEdges; ++e )
-        {
-            pairs[e].first = sources_[e];
-            pairs[e].second = targets_[e];
-        }
-        std::sort( pairs.begin(), pairs.end(), ComparePairs );
-
-        // Compress out duplicates
-        int lastUnique=0;
-        for( int e=1; e<numLocalEdges; ++e )
-            if( pairs[e] != pairs[lastUnique] )
-                pairs[++lastUnique] = pairs[e];
-        const int numUnique = lastUnique+1;
-
-        sources_.resize( numUnique );
-        targets_.resize( numUnique );
-        for( int e=0; e<numUnique; ++e )
+        const int edgeBeg = localEdgeOffsets[s];
+        const int edgeEnd = localEdgeOffsets[s+1];
+        for( int e=edgeBeg; e<edgeEnd; ++e )
         {
-            sources_[e] = pairs[e].first;
-            targets_[e] = pairs[e].second;
+            const int target = targets[e];
+            inBounds = inBounds && target >= 0 && target < numTargets_;
+            sorted = sorted && ( e == edgeBeg || target > targets[e-1] );
         }
     }
+    if( !inBounds )
+        LogicError("A target was out of bounds");
+
+    localEdgeOffsets_.swap( localEdgeOffsets );
+    targets_.swap( targets );
+    SwapClear( localEdgeOffsets );
+    SwapClear( targets );
+
+    // Expand the sources
+    sources_.resize( numLocalEdges );
+#ifdef HAVE_OPENMP
+    #pragma omp parallel for
+#endif
+    for( int s=0; s<numLocalSources_; ++s )
+    {
+        const int edgeBeg = localEdgeOffsets_[s];
+        const int edgeEnd = localEdgeOffsets_[s+1];
+        for( int e=edgeBeg; e<edgeEnd; ++e )
+            sources_[e] = firstLocalSource_ + s;
+    }
+    sorted_ = true;
+    return sorted;
+}
 
-    ComputeLocalEdgeOffsets();
+inline void
+DistGraph::AssembleFromCSR
+( std::vector<int> localEdgeOffsets, std::vector<int> targets )
+{
+    DEBUG_ONLY(CallStackEntry cse("DistGraph::AssembleFromCSR"))
+    if( !AdoptLocalCSR( localEdgeOffsets, targets ) )
+    {
+        SortAndCombinePairs
+        ( sources_, targets_, firstLocalSource_, numLocalSources_, 
+          numTargets_ );
+        ComputeLocalEdgeOffsets();
+    }
 }
 
 inline void
@@ -70,8 +70,16 @@ public:
     // Assignment
     const DistMap& operator=( const DistMap& map );
 
+    // Each modification of the map (including handing out mutable access to 
+    // its local data) stamps it with a version which no other state of any 
+    // map in this process has carried, so that patterns derived from the map
+    // can be checked for staleness without communication. Every process must
+    // therefore take part in each modification of a map.
+    std::size_t Version() const;
+
 private:
     int numSources_;
+    std::size_t version_;
 
     mpi::Comm comm_;
 
@@ -14,19 +14,26 @@
 
 namespace cliq {
 
+inline std::size_t
+NewDistMapVersion()
+{
+    static std::atomic<std::size_t> counter(0);
+    return ++counter;
+}
+
 inline
 DistMap::DistMap()
-: numSources_(0), comm_(mpi::COMM_WORLD)
+: numSources_(0), version_(0), comm_(mpi::COMM_WORLD)
 { SetComm( mpi::COMM_WORLD ); } 
 
 inline
 DistMap::DistMap( mpi::Comm comm )
-: numSources_(0), comm_(mpi::COMM_WORLD)
+: numSources_(0), version_(0), comm_(mpi::COMM_WORLD)
 { SetComm( comm ); }
 
 inline
 DistMap::DistMap( int numSources, mpi::Comm comm )
-: numSources_(numSources), comm_(mpi::COMM_WORLD)
+: numSources_(numSources), version_(0), comm_(mpi::COMM_WORLD)
 { SetComm( comm ); }
 
 inline
@@ -276,6 +283,7 @@ DistMap::Extend( DistMap& firstMap ) const
         //       are compatible sizes.
     )
     Translate( firstMap.map_ ); 
+    firstMap.version_ = NewDistMapVersion();
 }
 
 inline void
@@ -293,6 +301,7 @@ DistMap::NumSources() const
 inline void
 DistMap::SetComm( mpi::Comm comm )
 {
+    version_ = NewDistMapVersion();
     if( comm_ != mpi::COMM_WORLD )
         mpi::Free( comm_ );
 
@@ -348,11 +357,15 @@ DistMap::SetLocal( int localSource, int target )
             LogicError("local source is out of bounds");
     )
     map_[localSource] = target; 
+    version_ = NewDistMapVersion();
 }
 
 inline std::vector<int>&
 DistMap::Map()
-{ return map_; }
+{ 
+    version_ = NewDistMapVersion();
+    return map_; 
+}
 
 inline const std::vector<int>&
 DistMap::Map() const
@@ -360,7 +373,10 @@ DistMap::Map() const
 
 inline int* 
 DistMap::Buffer() 
-{ return &map_[0]; }
+{ 
+    version_ = NewDistMapVersion();
+    return &map_[0]; 
+}
 
 inline const int*
 DistMap::Buffer() const
@@ -369,6 +385,7 @@ DistMap::Buffer() const
 inline void
 DistMap::Empty()
 {
+    version_ = NewDistMapVersion();
     numSources_ = 0;
     blocksize_ = 0;
     firstLocalSource_ = 0;
@@ -378,6 +395,7 @@ DistMap::Empty()
 inline void
 DistMap::Resize( int numSources )
 {
+    version_ = NewDistMapVersion();
     const int commRank = mpi::Rank( comm_ );
     const int commSize = mpi::Size( comm_ );
     numSources_ = numSources;
@@ -395,9 +413,14 @@ DistMap::operator=( const DistMap& map )
     numSources_ = map.numSources_;
     SetComm( map.comm_ );
     map_ = map.map_;
+    version_ = NewDistMapVersion();
     return *this;
 }
 
+inline std::size_t
+DistMap::Version() const
+{ return version_; }
+
 } // namespace cliq
 
 #endif // ifndef CLIQ_CORE_DISTMAP_IMPL_HPP
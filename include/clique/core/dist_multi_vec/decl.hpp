@@ -44,6 +44,9 @@ public:
     T GetLocal( int localRow, int col ) const;
     void SetLocal( int localRow, int col, T value );
     void UpdateLocal( int localRow, int col, T value );
+    // Direct access to the (column-major) local rows
+    Matrix<T>& LocalMatrix();
+    const Matrix<T>& LockedLocalMatrix() const;
 
     // For modifying the size of the multi-vector
     void Empty();
@@ -83,6 +86,10 @@ Base<F> Norm( const DistMultiVec<F>& x );
 template<typename T>
 void Axpy( T alpha, const DistMultiVec<T>& X, DistMultiVec<T>& Y );
 
+// Y := X, with the entries converted to the (e.g., lower-precision) type of Y
+template<typename S,typename T>
+void Convert( const DistMultiVec<S>& X, DistMultiVec<T>& Y );
+
 } // namespace cliq
 
 #endif // ifndef CLIQ_CORE_DISTMULTIVEC_DECL_HPP
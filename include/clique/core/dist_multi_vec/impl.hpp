@@ -134,6 +134,28 @@ Axpy( T alpha, const DistMultiVec<T>& X, DistMultiVec<T>& Y )
             Y.UpdateLocal( iLocal, j, alpha*X.GetLocal(iLocal,j) );
 }
 
+template<typename S,typename T>
+inline void
+Convert( const DistMultiVec<S>& X, DistMultiVec<T>& Y )
+{
+    DEBUG_ONLY(CallStackEntry cse("Convert"))
+    // Avoid duplicating the communicator when Y is reused
+    if( !mpi::Congruent( X.Comm(), Y.Comm() ) )
+        Y.SetComm( X.Comm() );
+    Y.Resize( X.Height(), X.Width() );
+    const int localHeight = X.LocalHeight();
+    const int width = X.Width();
+    const Matrix<S>& XLoc = X.LockedLocalMatrix();
+    Matrix<T>& YLoc = Y.LocalMatrix();
+    const S* XBuf = XLoc.LockedBuffer();
+    T* YBuf = YLoc.Buffer();
+    const int XLDim = XLoc.LDim();
+    const int YLDim = YLoc.LDim();
+    for( int j=0; j<width; ++j )
+        for( int iLocal=0; iLocal<localHeight; ++iLocal )
+            YBuf[iLocal+j*YLDim] = T(XBuf[iLocal+j*XLDim]);
+}
+
 template<typename T>
 inline 
 DistMultiVec<T>::DistMultiVec()
@@ -243,6 +265,16 @@ DistMultiVec<T>::UpdateLocal( int localRow, int col, T value )
     multiVec_.Update(localRow,col,value);
 }
 
+template<typename T>
+inline Matrix<T>&
+DistMultiVec<T>::LocalMatrix()
+{ return multiVec_; }
+
+template<typename T>
+inline const Matrix<T>&
+DistMultiVec<T>::LockedLocalMatrix() const
+{ return multiVec_; }
+
 template<typename T>
 inline void
 DistMultiVec<T>::Empty()
@@ -23,6 +23,16 @@ struct SparseMultMeta
                      recvSizes, recvOffs;
     std::vector<int> sendInds, colOffs;
 
+    // The local entries are split into those whose column corresponds to a
+    // locally-owned row of X (and colOffs[e] is that local row) and those
+    // which require rows of X from other processes (and colOffs[e] indexes
+    // into the received rows). Each set is stored in a compressed row format
+    // so that the local product can overlap the exchange of the halo.
+    std::vector<int> localRowOffs, localEntries, 
+                     haloRowOffs, haloEntries;
+
+    CommPlan plan;
+
     SparseMultMeta() : ready(false) { }
 };
 
@@ -38,6 +48,11 @@ public:
     DistSparseMatrix( mpi::Comm comm );
     DistSparseMatrix( int height, mpi::Comm comm );
     DistSparseMatrix( int height, int width, mpi::Comm comm );
+    // Adopt local compressed-row data (see AssembleFromCSR)
+    DistSparseMatrix
+    ( int height, int width, mpi::Comm comm, 
+      std::vector<int> localEntryOffsets, std::vector<int> targets, 
+      std::vector<T> values );
     // TODO: Constructor for building from another DistSparseMatrix
     ~DistSparseMatrix();
 
@@ -57,12 +72,28 @@ public:
     int LocalHeight() const;
 
     // Assembly-related routines
-    void StartAssembly();
-    void StopAssembly();
+    //
+    // If 'stashOffProcess' is true, then Update may be called for rows owned 
+    // by other processes: such updates are buffered and then sent to their 
+    // owners within StopAssembly (which all processes must then call). 
+    void StartAssembly( bool stashOffProcess=false );
+    // If 'buildMultMeta' is true, then the communication pattern used by
+    // Multiply is also computed (which requires all processes to participate)
+    void StopAssembly( bool buildMultMeta=false );
     void Reserve( int numLocalEntries );
     void Update( int row, int col, T value );
     int Capacity() const;
 
+    // Replace the local entries with a compressed-row structure, where the 
+    // columns and values of local row iLocal are stored in positions 
+    // localEntryOffsets[iLocal] through localEntryOffsets[iLocal+1]-1 of 
+    // 'targets' and 'values'. The arrays are adopted (pass them with 
+    // std::move to avoid any copies), and the sort is skipped if the columns
+    // of each row are already strictly increasing.
+    void AssembleFromCSR
+    ( std::vector<int> localEntryOffsets, std::vector<int> targets,
+      std::vector<T> values );
+
     // Local data
     int Row( int localInd ) const;
     int Col( int localInd ) const;
@@ -90,7 +121,11 @@ private:
     cliq::DistGraph distGraph_;
     std::vector<T> vals_;
 
-    static bool CompareEntries( const Entry<T>& a, const Entry<T>& b );
+    // The buffered updates of rows owned by other processes
+    bool stashing_;
+    std::vector<int> stashRows_, stashCols_;
+    std::vector<T> stashVals_;
+    void ExchangeStash();
 
     void EnsureConsistentSizes() const;
     void EnsureConsistentCapacities() const;
@@ -99,6 +134,14 @@ private:
     template<typename U> friend struct DistSymmFrontTree;
 };
 
+// Compute the communication pattern and local splitting used by Multiply
+template<typename T>
+void BuildSparseMultMeta( const DistSparseMatrix<T>& A );
+
+// B := A, with the entries converted to the (e.g., lower-precision) type of B
+template<typename S,typename T>
+void Convert( const DistSparseMatrix<S>& A, DistSparseMatrix<T>& B );
+
 } // namespace cliq
 
 #endif // ifndef CLIQ_CORE_DISTSPARSEMATRIX_DECL_HPP
@@ -17,30 +17,44 @@ namespace cliq {
 template<typename T>
 inline 
 DistSparseMatrix<T>::DistSparseMatrix()
+: stashing_(false)
 { }
 
 template<typename T>
 inline 
 DistSparseMatrix<T>::DistSparseMatrix( mpi::Comm comm )
-: distGraph_(comm)
+: distGraph_(comm), stashing_(false)
 { }
 
 template<typename T>
 inline
 DistSparseMatrix<T>::DistSparseMatrix( int height, mpi::Comm comm )
-: distGraph_(height,comm)
+: distGraph_(height,comm), stashing_(false)
 { }
 
 template<typename T>
 inline 
 DistSparseMatrix<T>::DistSparseMatrix( int height, int width, mpi::Comm comm )
-: distGraph_(height,width,comm)
+: distGraph_(height,width,comm), stashing_(false)
 { }
 
+template<typename T>
+inline 
+DistSparseMatrix<T>::DistSparseMatrix
+( int height, int width, mpi::Comm comm, 
+  std::vector<int> localEntryOffsets, std::vector<int> targets, 
+  std::vector<T> values )
+: distGraph_(height,width,comm), stashing_(false)
+{ 
+    DEBUG_ONLY(CallStackEntry cse("DistSparseMatrix::DistSparseMatrix"))
+    AssembleFromCSR
+    ( std::move(localEntryOffsets), std::move(targets), std::move(values) );
+}
+
 template<typename T>
 inline 
 DistSparseMatrix<T>::~DistSparseMatrix()
-{ }
+{ multMeta.plan.Empty(); }
 
 template<typename T>
 inline int 
@@ -66,6 +80,9 @@ template<typename T>
 inline void
 DistSparseMatrix<T>::SetComm( mpi::Comm comm )
 { 
+    // The halo plan must be freed before the communicator it was built over
+    multMeta.ready = false;
+    multMeta.plan.Empty();
     distGraph_.SetComm( comm ); 
     SwapClear( vals_ );
 }
@@ -187,73 +204,42 @@ inline const T*
 DistSparseMatrix<T>::LockedValueBuffer() const
 { return &vals_[0]; }
 
-template<typename T>
-inline bool
-DistSparseMatrix<T>::CompareEntries( const Entry<T>& a, const Entry<T>& b )
-{
-    return a.i < b.i || (a.i == b.i && a.j < b.j);
-}
-
 template<typename T>
 inline void
-DistSparseMatrix<T>::StartAssembly()
+DistSparseMatrix<T>::StartAssembly( bool stashOffProcess )
 {
     DEBUG_ONLY(CallStackEntry cse("DistSparseMatrix::StartAssembly"))
     multMeta.ready = false;
     distGraph_.EnsureNotAssembling();
     distGraph_.assembling_ = true;
+    stashing_ = stashOffProcess;
 }
 
 template<typename T>
 inline void
-DistSparseMatrix<T>::StopAssembly()
+DistSparseMatrix<T>::StopAssembly( bool buildMultMeta )
 {
     DEBUG_ONLY(CallStackEntry cse("DistSparseMatrix::StopAssembly"))
     if( !distGraph_.assembling_ )
         LogicError("Cannot stop assembly without starting");
     distGraph_.assembling_ = false;
-
-    // Ensure that the connection pairs are sorted
-    if( !distGraph_.sorted_ )
+    if( stashing_ )
     {
-        const int numLocalEntries = vals_.size();
-        std::vector<Entry<T>> entries( numLocalEntries );
-        for( int s=0; s<numLocalEntries; ++s )
-        {
-            entries[s].i = distGraph_.sources_[s];
-            entries[s].j = distGraph_.targets_[s];
-            entries[s].value = vals_[s];
-        }
-        std::sort( entries.begin(), entries.end(), CompareEntries );
-
-        // Compress out duplicates
-        int lastUnique=0;
-        for( int s=1; s<numLocalEntries; ++s )
-        {
-            if( entries[s].i != entries[lastUnique].i ||
-                entries[s].j != entries[lastUnique].j )
-            {
-                ++lastUnique;
-                entries[lastUnique].i = entries[s].i;
-                entries[lastUnique].j = entries[s].j;
-                entries[lastUnique].value = entries[s].value;
-            }
-            else
-                entries[lastUnique].value += entries[s].value;
-        }
-        const int numUnique = lastUnique+1;
-
-        distGraph_.sources_.resize( numUnique );
-        distGraph_.targets_.resize( numUnique );
-        vals_.resize( numUnique );
-        for( int s=0; s<numUnique; ++s )
-        {
-            distGraph_.sources_[s] = entries[s].i;
-            distGraph_.targets_[s] = entries[s].j;
-            vals_[s] = entries[s].value;
-        }
+        ExchangeStash();
+        stashing_ = false;
     }
+
+    // Ensure that the connection pairs are sorted and unique, summing the
+    // values of repeated updates
+    SortAndCombinePairs
+    ( distGraph_.sources_, distGraph_.targets_, vals_, 
+      distGraph_.firstLocalSource_, distGraph_.numLocalSources_, 
+      distGraph_.numTargets_, distGraph_.sorted_ );
+    distGraph_.sorted_ = true;
     distGraph_.ComputeLocalEdgeOffsets();
+
+    if( buildMultMeta )
+        BuildSparseMultMeta( *this );
 }
 
 template<typename T>
@@ -272,16 +258,135 @@ DistSparseMatrix<T>::Update( int row, int col, T value )
         CallStackEntry cse("DistSparseMatrix::Update");
         EnsureConsistentSizes();
     )
+    if( stashing_ )
+    {
+        const int firstLocalRow = distGraph_.firstLocalSource_;
+        if( row < firstLocalRow || 
+            row >= firstLocalRow+distGraph_.numLocalSources_ )
+        {
+            stashRows_.push_back( row );
+            stashCols_.push_back( col );
+            stashVals_.push_back( value );
+            return;
+        }
+    }
     distGraph_.Insert( row, col );
     vals_.push_back( value );
 }
 
+template<typename T>
+inline void
+DistSparseMatrix<T>::AssembleFromCSR
+( std::vector<int> localEntryOffsets, std::vector<int> targets,
+  std::vector<T> values )
+{
+    DEBUG_ONLY(CallStackEntry cse("DistSparseMatrix::AssembleFromCSR"))
+    if( values.size() != targets.size() )
+        LogicError("Number of values did not match the number of targets");
+    // The graph validates the structure before adopting it, so the values
+    // are only adopted once the structure has been accepted
+    const bool sorted = distGraph_.AdoptLocalCSR( localEntryOffsets, targets );
+    multMeta.ready = false;
+    vals_.swap( values );
+    SwapClear( values );
+    if( !sorted )
+    {
+        SortAndCombinePairs
+        ( distGraph_.sources_, distGraph_.targets_, vals_,
+          distGraph_.firstLocalSource_, distGraph_.numLocalSources_,
+          distGraph_.numTargets_ );
+        distGraph_.ComputeLocalEdgeOffsets();
+    }
+}
+
+template<typename T>
+inline void
+DistSparseMatrix<T>::ExchangeStash()
+{
+    DEBUG_ONLY(CallStackEntry cse("DistSparseMatrix::ExchangeStash"))
+    mpi::Comm comm = distGraph_.Comm();
+    const int commSize = mpi::Size( comm );
+    const int blocksize = distGraph_.Blocksize();
+
+    // Pack the stashed updates by their owner
+    const int numStashed = stashRows_.size();
+    std::vector<int> sendSizes( commSize, 0 );
+    for( int k=0; k<numStashed; ++k )
+    {
+        const int row = stashRows_[k];
+        DEBUG_ONLY(
+            if( row < 0 || row >= Height() )
+                LogicError("Stashed row ",row," was out of bounds");
+        )
+        ++sendSizes[RowToProcess(row,blocksize,commSize)];
+    }
+    std::vector<int> sendOffs( commSize );
+    int off=0;
+    for( int q=0; q<commSize; ++q )
+    {
+        sendOffs[q] = off;
+        off += sendSizes[q];
+    }
+    std::vector<int> sendRows( numStashed ), sendCols( numStashed );
+    std::vector<T> sendVals( numStashed );
+    std::vector<int> offs = sendOffs;
+    for( int k=0; k<numStashed; ++k )
+    {
+        const int q = RowToProcess( stashRows_[k], blocksize, commSize );
+        sendRows[offs[q]] = stashRows_[k];
+        sendCols[offs[q]] = stashCols_[k];
+        sendVals[offs[q]] = stashVals_[k];
+        ++offs[q];
+    }
+    SwapClear( offs );
+    SwapClear( stashRows_ );
+    SwapClear( stashCols_ );
+    SwapClear( stashVals_ );
+
+    // Exchange the updates in one batch
+    std::vector<int> recvSizes( commSize );
+    mpi::AllToAll( &sendSizes[0], 1, &recvSizes[0], 1, comm );
+    int numRecv=0;
+    std::vector<int> recvOffs( commSize );
+    for( int q=0; q<commSize; ++q )
+    {
+        recvOffs[q] = numRecv;
+        numRecv += recvSizes[q];
+    }
+    std::vector<int> recvRows( numRecv ), recvCols( numRecv );
+    std::vector<T> recvVals( numRecv );
+    mpi::AllToAll
+    ( &sendRows[0], &sendSizes[0], &sendOffs[0],
+      &recvRows[0], &recvSizes[0], &recvOffs[0], comm );
+    mpi::AllToAll
+    ( &sendCols[0], &sendSizes[0], &sendOffs[0],
+      &recvCols[0], &recvSizes[0], &recvOffs[0], comm );
+    mpi::AllToAll
+    ( &sendVals[0], &sendSizes[0], &sendOffs[0],
+      &recvVals[0], &recvSizes[0], &recvOffs[0], comm );
+
+    // Append the received updates (duplicates are summed during the sort)
+    if( numRecv != 0 )
+    {
+        distGraph_.sources_.insert
+        ( distGraph_.sources_.end(), recvRows.begin(), recvRows.end() );
+        distGraph_.targets_.insert
+        ( distGraph_.targets_.end(), recvCols.begin(), recvCols.end() );
+        vals_.insert( vals_.end(), recvVals.begin(), recvVals.end() );
+        distGraph_.sorted_ = false;
+    }
+}
+
 template<typename T>
 inline void
 DistSparseMatrix<T>::Empty()
 {
     distGraph_.Empty();
     SwapClear( vals_ );
+    SwapClear( stashRows_ );
+    SwapClear( stashCols_ );
+    SwapClear( stashVals_ );
+    stashing_ = false;
 }
 
 template<typename T>
@@ -310,6 +415,128 @@ DistSparseMatrix<T>::EnsureConsistentCapacities() const
         LogicError("Inconsistent sparsity capacities");
 }
 
+template<typename T>
+inline void
+BuildSparseMultMeta( const DistSparseMatrix<T>& A )
+{
+    DEBUG_ONLY(CallStackEntry cse("BuildSparseMultMeta"))
+    SparseMultMeta<T>& meta = A.multMeta;
+    mpi::Comm comm = A.Comm();
+    const int commSize = mpi::Size( comm );
+    const int blocksize = A.Blocksize();
+    const int firstLocalRow = A.FirstLocalRow();
+    const int localHeight = A.LocalHeight();
+    const int numLocalEntries = A.NumLocalEntries();
+
+    // Split the entries of each row into local and halo pieces, and sort the
+    // halo entries by their column (the local index of each entry is packed
+    // into the low bits of the key so that a single sort suffices)
+    meta.colOffs.resize( numLocalEntries );
+    meta.localRowOffs.resize( localHeight+1 );
+    meta.haloRowOffs.resize( localHeight+1 );
+    meta.localEntries.resize( numLocalEntries );
+    meta.haloEntries.resize( numLocalEntries );
+    std::vector<unsigned long long> haloKeys;
+    int numLocal=0, numHalo=0;
+    for( int iLocal=0; iLocal<localHeight; ++iLocal )
+    {
+        meta.localRowOffs[iLocal] = numLocal;
+        meta.haloRowOffs[iLocal] = numHalo;
+        const int off = A.LocalEntryOffset( iLocal );
+        const int rowSize = A.NumConnections( iLocal );
+        for( int e=off; e<off+rowSize; ++e )
+        {
+            const int j = A.Col(e);
+            if( j >= firstLocalRow && j < firstLocalRow+localHeight )
+            {
+                meta.colOffs[e] = j - firstLocalRow;
+                meta.localEntries[numLocal++] = e;
+            }
+            else
+            {
+                meta.haloEntries[numHalo++] = e;
+                haloKeys.push_back
+                ( (static_cast<unsigned long long>(j)<<32) | 
+                  static_cast<unsigned>(e) );
+            }
+        }
+    }
+    meta.localRowOffs[localHeight] = numLocal;
+    meta.haloRowOffs[localHeight] = numHalo;
+    meta.localEntries.resize( numLocal );
+    meta.haloEntries.resize( numHalo );
+    std::sort( haloKeys.begin(), haloKeys.end() );
+
+    // Compress the sorted columns into the list of rows that we need from 
+    // other processes while assigning each halo entry its receive offset
+    std::vector<int> recvInds;
+    meta.recvSizes.clear();
+    meta.recvSizes.resize( commSize, 0 );
+    meta.recvOffs.resize( commSize );
+    for( int k=0; k<numHalo; ++k )
+    {
+        const int j = haloKeys[k] >> 32;
+        const int e = haloKeys[k] & 0xffffffffULL;
+        if( recvInds.empty() || recvInds.back() != j )
+        {
+            recvInds.push_back( j );
+            ++meta.recvSizes[RowToProcess(j,blocksize,commSize)];
+        }
+        meta.colOffs[e] = recvInds.size()-1;
+    }
+    SwapClear( haloKeys );
+    const int numRecvInds = recvInds.size();
+    int off=0;
+    for( int q=0; q<commSize; ++q )
+    {
+        meta.recvOffs[q] = off;
+        off += meta.recvSizes[q];
+    }
+
+    // Coordinate
+    meta.sendSizes.resize( commSize );
+    mpi::AllToAll( &meta.recvSizes[0], 1, &meta.sendSizes[0], 1, comm );
+    int numSendInds=0;
+    meta.sendOffs.resize( commSize );
+    for( int q=0; q<commSize; ++q )
+    {
+        meta.sendOffs[q] = numSendInds;
+        numSendInds += meta.sendSizes[q];
+    }
+    meta.sendInds.resize( numSendInds );
+    mpi::AllToAll
+    ( &recvInds[0],       &meta.recvSizes[0], &meta.recvOffs[0],
+      &meta.sendInds[0], &meta.sendSizes[0], &meta.sendOffs[0], comm );
+
+    meta.plan.Empty();
+    meta.numRecvInds = numRecvInds;
+    meta.ready = true;
+}
+
+template<typename S,typename T>
+inline void
+Convert( const DistSparseMatrix<S>& A, DistSparseMatrix<T>& B )
+{
+    DEBUG_ONLY(CallStackEntry cse("Convert"))
+    const int localHeight = A.LocalHeight();
+    const int numLocalEntries = A.NumLocalEntries();
+    std::vector<int> localEntryOffsets( localHeight+1 );
+    for( int iLocal=0; iLocal<=localHeight; ++iLocal )
+        localEntryOffsets[iLocal] = A.LocalEntryOffset( iLocal );
+    std::vector<int> targets( numLocalEntries );
+    std::vector<T> values( numLocalEntries );
+    for( int e=0; e<numLocalEntries; ++e )
+    {
+        targets[e] = A.Col( e );
+        values[e] = T(A.Value(e));
+    }
+
+    B.SetComm( A.Comm() );
+    B.Resize( A.Height(), A.Width() );
+    B.AssembleFromCSR
+    ( std::move(localEntryOffsets), std::move(targets), std::move(values) );
+}
+
 } // namespace cliq
 
 #endif // ifndef CLIQ_CORE_DISTSPARSEMATRIX_IMPL_HPP
@@ -36,6 +36,12 @@ using El::Complex;
 using El::Abs;
 using El::Sqrt;
 
+// The single-precision counterpart of a double-precision scalar type (e.g., for
+// factoring in single precision and refining in double precision)
+template<typename F> struct Demote { typedef F type; };
+template<> struct Demote<double> { typedef float type; };
+template<> struct Demote<Complex<double>> { typedef Complex<float> type; };
+
 // Pull in a few classes from Elemental
 using El::Matrix;
 using El::Grid;
@@ -134,6 +140,24 @@ void RelativeIndices
 std::vector<Int>
 RelativeIndices( const std::vector<Int>& sub, const std::vector<Int>& full );
 
+// Splits a strictly increasing list of relative indices into maximal runs of
+// consecutive values: run r occupies positions [runStarts[r],runStarts[r+1])
+void ContiguousRuns
+( std::vector<Int>& runStarts, const std::vector<Int>& relInds );
+
+// Sort the (source,target) pairs (and their values) with a multithreaded 
+// least-significant-digit radix sort and then combine duplicate pairs (by 
+// summing their values). The sources must lie within 
+// [firstSource,firstSource+numSources) and the targets within [0,numTargets).
+// If 'sorted' is true, then the pairs are only combined.
+void SortAndCombinePairs
+( std::vector<Int>& sources, std::vector<Int>& targets,
+  Int firstSource, Int numSources, Int numTargets, bool sorted=false );
+template<typename T>
+void SortAndCombinePairs
+( std::vector<Int>& sources, std::vector<Int>& targets, std::vector<T>& values,
+  Int firstSource, Int numSources, Int numTargets, bool sorted=false );
+
 Int RowToProcess( Int i, Int blocksize, Int commSize );
 
 Int Find
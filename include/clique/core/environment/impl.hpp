@@ -138,6 +138,192 @@ inline std::vector<Int> RelativeIndices
     return relInds;
 }
 
+inline void ContiguousRuns
+( std::vector<Int>& runStarts, const std::vector<Int>& relInds )
+{
+    DEBUG_ONLY(
+        CallStackEntry cse("ContiguousRuns");
+        if( !IsStrictlySorted( relInds ) )
+            LogicError("Relative indices were not strictly sorted");
+    )
+    const Int numInds = relInds.size();
+    runStarts.resize( 0 );
+    for( Int i=0; i<numInds; ++i )
+        if( i == 0 || relInds[i] != relInds[i-1]+1 )
+            runStarts.push_back( i );
+    runStarts.push_back( numInds );
+}
+
+// The number of bits of the key which are sorted by each radix pass
+const int radixSortBits = 11;
+
+// A stable counting sort of the pairs on bits [shift,shift+radixSortBits) of
+// either (source-firstSource) or the target
+template<typename T>
+inline void
+RadixPass
+( Int n, bool bySource, Int firstSource, int shift,
+  const Int* sourcesIn,  const Int* targetsIn,  const T* valuesIn,
+        Int* sourcesOut,       Int* targetsOut,       T* valuesOut,
+  std::vector<Int>& counts )
+{
+    const Int numBuckets = Int(1) << radixSortBits;
+    const Int mask = numBuckets-1;
+    const Int* keys = ( bySource ? sourcesIn : targetsIn );
+    const Int keyOffset = ( bySource ? firstSource : 0 );
+#ifdef HAVE_OPENMP
+    #pragma omp parallel
+#endif
+    {
+#ifdef HAVE_OPENMP
+        const int numThreads = omp_get_num_threads();
+        const int thread = omp_get_thread_num();
+        #pragma omp single
+#else
+        const int numThreads = 1;
+        const int thread = 0;
+#endif
+        counts.assign( numThreads*numBuckets, 0 );
+
+        // Histogram this thread's contiguous chunk of the pairs
+        const Int kBeg = (static_cast<long long>(n)*thread)/numThreads;
+        const Int kEnd = (static_cast<long long>(n)*(thread+1))/numThreads;
+        Int* myCounts = &counts[thread*numBuckets];
+        for( Int k=kBeg; k<kEnd; ++k )
+            ++myCounts[((keys[k]-keyOffset)>>shift)&mask];
+#ifdef HAVE_OPENMP
+        #pragma omp barrier
+        #pragma omp single
+#endif
+        {
+            // Turn the counts into starting offsets, ordered first by bucket
+            // and then by thread so that the sort is stable
+            Int off=0;
+            for( Int b=0; b<numBuckets; ++b )
+            {
+                for( int t=0; t<numThreads; ++t )
+                {
+                    const Int count = counts[t*numBuckets+b];
+                    counts[t*numBuckets+b] = off;
+                    off += count;
+                }
+            }
+        }
+
+        for( Int k=kBeg; k<kEnd; ++k )
+        {
+            const Int dest = myCounts[((keys[k]-keyOffset)>>shift)&mask]++;
+            sourcesOut[dest] = sourcesIn[k];
+            targetsOut[dest] = targetsIn[k];
+            if( valuesIn != 0 )
+                valuesOut[dest] = valuesIn[k];
+        }
+    }
+}
+
+template<typename T>
+inline void
+RadixSortPairs
+( Int n, Int* sources, Int* targets, T* values, 
+  Int firstSource, Int numSources, Int numTargets )
+{
+    DEBUG_ONLY(CallStackEntry cse("RadixSortPairs"))
+
+    // Sort on the targets and then on the sources, alternating between the
+    // original arrays and the workspace
+    std::vector<Int> sourceBuf( n ), targetBuf( n ), counts;
+    std::vector<T> valueBuf( values==0 ? 0 : n );
+    Int *sourcesIn=sources, *targetsIn=targets;
+    Int *sourcesOut=&sourceBuf[0], *targetsOut=&targetBuf[0];
+    T *valuesIn=values, *valuesOut=( values==0 ? 0 : &valueBuf[0] );
+    for( int pass=0; pass<2; ++pass )
+    {
+        const bool bySource = ( pass == 1 );
+        const Int maxKey = ( bySource ? numSources-1 : numTargets-1 );
+        for( int shift=0; (maxKey>>shift) != 0; shift+=radixSortBits )
+        {
+            RadixPass
+            ( n, bySource, firstSource, shift, 
+              sourcesIn, targetsIn, valuesIn, 
+              sourcesOut, targetsOut, valuesOut, counts );
+            std::swap( sourcesIn, sourcesOut );
+            std::swap( targetsIn, targetsOut );
+            std::swap( valuesIn, valuesOut );
+        }
+    }
+    if( sourcesIn != sources )
+    {
+        std::copy( sourcesIn, sourcesIn+n, sources );
+        std::copy( targetsIn, targetsIn+n, targets );
+        if( values != 0 )
+            std::copy( valuesIn, valuesIn+n, values );
+    }
+}
+
+// If 'values' is nonzero, then it is permuted along with the pairs, and the
+// values of duplicate pairs are summed. Returns the number of unique pairs.
+template<typename T>
+inline Int
+RadixSortAndCombine
+( Int n, Int* sources, Int* targets, T* values, 
+  Int firstSource, Int numSources, Int numTargets, bool sorted )
+{
+    DEBUG_ONLY(CallStackEntry cse("RadixSortAndCombine"))
+    if( n == 0 )
+        return 0;
+    if( !sorted )
+        RadixSortPairs
+        ( n, sources, targets, values, firstSource, numSources, numTargets );
+
+    // Combine the duplicates in place
+    Int lastUnique=0;
+    for( Int k=1; k<n; ++k )
+    {
+        if( sources[k] != sources[lastUnique] || 
+            targets[k] != targets[lastUnique] )
+        {
+            ++lastUnique;
+            sources[lastUnique] = sources[k];
+            targets[lastUnique] = targets[k];
+            if( values != 0 )
+                values[lastUnique] = values[k];
+        }
+        else if( values != 0 )
+            values[lastUnique] += values[k];
+    }
+    return lastUnique+1;
+}
+
+inline void
+SortAndCombinePairs
+( std::vector<Int>& sources, std::vector<Int>& targets,
+  Int firstSource, Int numSources, Int numTargets, bool sorted )
+{
+    DEBUG_ONLY(CallStackEntry cse("SortAndCombinePairs"))
+    const Int n = sources.size();
+    const Int numUnique = RadixSortAndCombine
+    ( n, &sources[0], &targets[0], static_cast<Int*>(0), 
+      firstSource, numSources, numTargets, sorted );
+    sources.resize( numUnique );
+    targets.resize( numUnique );
+}
+
+template<typename T>
+inline void
+SortAndCombinePairs
+( std::vector<Int>& sources, std::vector<Int>& targets, std::vector<T>& values,
+  Int firstSource, Int numSources, Int numTargets, bool sorted )
+{
+    DEBUG_ONLY(CallStackEntry cse("SortAndCombinePairs"))
+    const Int n = sources.size();
+    const Int numUnique = RadixSortAndCombine
+    ( n, &sources[0], &targets[0], &values[0], 
+      firstSource, numSources, numTargets, sorted );
+    sources.resize( numUnique );
+    targets.resize( numUnique );
+    values.resize( numUnique );
+}
+
 inline Int
 RowToProcess( Int i, Int blocksize, Int commSize )
 {
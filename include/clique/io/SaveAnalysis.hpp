@@ -0,0 +1,532 @@
+/*
+   Copyright (c) 2009-2014, Jack Poulson, Lexing Ying,
+   The University of Texas at Austin, Stanford University, and the
+   Georgia Insitute of Technology.
+   All rights reserved.
+ 
+   This file is part of Clique and is under the BSD 2-Clause License, 
+   which can be found in the LICENSE file in the root directory, or at 
+   http://opensource.org/licenses/BSD-2-Clause
+*/
+#pragma once
+#ifndef CLIQ_IO_SAVEANALYSIS_HPP
+#define CLIQ_IO_SAVEANALYSIS_HPP
+
+namespace cliq {
+
+// A hash of the structure of a distributed graph (its sizes and the targets
+// of each source), which is identical on every process of its communicator
+unsigned long long GraphHash( const DistGraph& graph );
+
+// A hash of the symbolic analysis (the sizes, offsets, and structures of the
+// local and distributed nodes), which is identical on every process
+unsigned long long AnalysisHash( const DistSymmInfo& info );
+
+// The options of NestedDissection (or, if 'natural' is true, of 
+// NaturalNestedDissection) which determine the analysis of a graph. They are
+// stored with the analysis so that a file which was written with different
+// options is rejected. The defaults match those of NestedDissection.
+struct AnalysisOptions
+{
+    bool natural;
+    bool sequential;
+    int numDistSeps, numSeqSeps;
+    int cutoff;
+    double maxZeroRatio, maxMemoryGrowth;
+    bool orderLeaves;
+
+    AnalysisOptions()
+    : natural(false), sequential(true), numDistSeps(1), numSeqSeps(1), 
+      cutoff(128), maxZeroRatio(0), maxMemoryGrowth(0.1), orderLeaves(false)
+    { }
+};
+
+// Write the reordering, separator tree, and symbolic analysis produced by
+// NestedDissection (or NaturalNestedDissection) for 'graph' into one binary
+// file per process, named "<basename>.<commRank>", along with the options
+// which the analysis was computed with
+void SaveAnalysis
+( const DistGraph& graph,
+  const DistMap& map,
+  const DistSeparatorTree& sepTree,
+  const DistSymmInfo& info,
+  std::string basename,
+  const AnalysisOptions& options=AnalysisOptions() );
+
+// Read the results of SaveAnalysis so that the ordering and the local
+// symbolic factorization can be skipped; the communicators and the
+// distributed part of the symbolic analysis are rebuilt. If any process
+// could not read a matching file (e.g., it was written for a different graph,
+// number of processes, or set of options), then false is returned on every 
+// process and the outputs are not modified.
+bool LoadAnalysis
+( const DistGraph& graph,
+        DistMap& map,
+        DistSeparatorTree& sepTree,
+        DistSymmInfo& info,
+  std::string basename,
+  const AnalysisOptions& options=AnalysisOptions(),
+  bool storeFactRecvInds=false );
+
+//----------------------------------------------------------------------------//
+// Implementation begins here                                                 //
+//----------------------------------------------------------------------------//
+
+// "CLIQANAL" and the version of the file layout
+const unsigned long long analysisFileMagic = 0x4c414e4151494c43ULL;
+const int analysisFileVersion = 2;
+
+inline std::string
+RankFilename( std::string basename, int commRank )
+{
+    std::ostringstream os;
+    os << basename << "." << commRank;
+    return os.str();
+}
+
+template<typename T>
+inline void
+WriteBinary( std::ofstream& file, const T& value )
+{ file.write( reinterpret_cast<const char*>(&value), sizeof(T) ); }
+
+template<typename T>
+inline void
+WriteBinary( std::ofstream& file, const std::vector<T>& vec )
+{
+    const int size = vec.size();
+    WriteBinary( file, size );
+    if( size != 0 )
+        file.write
+        ( reinterpret_cast<const char*>(&vec[0]), size*sizeof(T) );
+}
+
+template<typename T>
+inline void
+ReadBinary( std::ifstream& file, T& value )
+{ file.read( reinterpret_cast<char*>(&value), sizeof(T) ); }
+
+template<typename T>
+inline void
+ReadBinary( std::ifstream& file, std::vector<T>& vec )
+{
+    int size=-1;
+    ReadBinary( file, size );
+    // Guard against resizing with garbage from a corrupted file
+    if( !file.good() || size < 0 )
+    {
+        file.setstate( std::ios::failbit );
+        return;
+    }
+    vec.resize( size );
+    if( size != 0 )
+        file.read( reinterpret_cast<char*>(&vec[0]), size*sizeof(T) );
+}
+
+inline void
+WriteBinary( std::ofstream& file, const AnalysisOptions& options )
+{
+    WriteBinary( file, int(options.natural) );
+    WriteBinary( file, int(options.sequential) );
+    WriteBinary( file, options.numDistSeps );
+    WriteBinary( file, options.numSeqSeps );
+    WriteBinary( file, options.cutoff );
+    WriteBinary( file, options.maxZeroRatio );
+    WriteBinary( file, options.maxMemoryGrowth );
+    WriteBinary( file, int(options.orderLeaves) );
+}
+
+// Compares the options stored in 'file' against 'options'
+inline bool
+ReadAndMatch( std::ifstream& file, const AnalysisOptions& options )
+{
+    int natural=-1, sequential=-1, orderLeaves=-1;
+    AnalysisOptions fileOptions;
+    ReadBinary( file, natural );
+    ReadBinary( file, sequential );
+    ReadBinary( file, fileOptions.numDistSeps );
+    ReadBinary( file, fileOptions.numSeqSeps );
+    ReadBinary( file, fileOptions.cutoff );
+    ReadBinary( file, fileOptions.maxZeroRatio );
+    ReadBinary( file, fileOptions.maxMemoryGrowth );
+    ReadBinary( file, orderLeaves );
+    return file.good() && 
+           natural == int(options.natural) &&
+           sequential == int(options.sequential) &&
+           fileOptions.numDistSeps == options.numDistSeps &&
+           fileOptions.numSeqSeps == options.numSeqSeps &&
+           fileOptions.cutoff == options.cutoff &&
+           fileOptions.maxZeroRatio == options.maxZeroRatio &&
+           fileOptions.maxMemoryGrowth == options.maxMemoryGrowth &&
+           orderLeaves == int(options.orderLeaves);
+}
+
+// 64-bit FNV-1a
+const unsigned long long hashBasis = 14695981039346656037ULL;
+const unsigned long long hashPrime = 1099511628211ULL;
+
+inline void
+MixHash( unsigned long long& hash, int value )
+{
+    const unsigned bits = value;
+    for( int k=0; k<4; ++k )
+    {
+        hash ^= (bits >> (8*k)) & 0xff;
+        hash *= hashPrime;
+    }
+}
+
+inline void
+MixHash( unsigned long long& hash, const std::vector<int>& values )
+{
+    const int numValues = values.size();
+    MixHash( hash, numValues );
+    for( int k=0; k<numValues; ++k )
+        MixHash( hash, values[k] );
+}
+
+// Combine the local hashes in rank order
+inline unsigned long long
+CombineHashes( unsigned long long localHash, mpi::Comm comm )
+{
+    const int commSize = mpi::Size( comm );
+    std::vector<unsigned long long> hashes( commSize );
+    MPI_Allgather
+    ( &localHash, 1, MPI_UNSIGNED_LONG_LONG, 
+      &hashes[0], 1, MPI_UNSIGNED_LONG_LONG, comm.comm );
+    unsigned long long hash = hashBasis;
+    for( int q=0; q<commSize; ++q )
+    {
+        hash ^= hashes[q];
+        hash *= hashPrime;
+    }
+    return hash;
+}
+
+inline unsigned long long
+GraphHash( const DistGraph& graph )
+{
+    DEBUG_ONLY(CallStackEntry cse("GraphHash"))
+    unsigned long long hash = hashBasis;
+    MixHash( hash, graph.NumSources() );
+    MixHash( hash, graph.NumTargets() );
+    const int numLocalSources = graph.NumLocalSources();
+    const int firstLocalSource = graph.FirstLocalSource();
+    for( int s=0; s<numLocalSources; ++s )
+    {
+        const int numConnections = graph.NumConnections( s );
+        const int localOff = graph.LocalEdgeOffset( s );
+        MixHash( hash, s+firstLocalSource );
+        MixHash( hash, numConnections );
+        for( int t=0; t<numConnections; ++t )
+            MixHash( hash, graph.Target( localOff+t ) );
+    }
+    return CombineHashes( hash, graph.Comm() );
+}
+
+inline unsigned long long
+AnalysisHash( const DistSymmInfo& info )
+{
+    DEBUG_ONLY(CallStackEntry cse("AnalysisHash"))
+    unsigned long long hash = hashBasis;
+    const int numLocalNodes = info.localNodes.size();
+    MixHash( hash, numLocalNodes );
+    for( int s=0; s<numLocalNodes; ++s )
+    {
+        const SymmNodeInfo& node = info.localNodes[s];
+        MixHash( hash, node.size );
+        MixHash( hash, node.off );
+        MixHash( hash, node.parent );
+        MixHash( hash, node.lowerStruct );
+    }
+    const int numDistNodes = info.distNodes.size();
+    MixHash( hash, numDistNodes );
+    for( int s=0; s<numDistNodes; ++s )
+    {
+        const DistSymmNodeInfo& node = info.distNodes[s];
+        MixHash( hash, node.size );
+        MixHash( hash, node.off );
+        MixHash( hash, int(node.onLeft) );
+        MixHash( hash, node.lowerStruct );
+    }
+    return CombineHashes( hash, info.distNodes.back().comm );
+}
+
+inline void
+SaveAnalysis
+( const DistGraph& graph, const DistMap& map,
+  const DistSeparatorTree& sepTree, const DistSymmInfo& info,
+  std::string basename, const AnalysisOptions& options )
+{
+    DEBUG_ONLY(CallStackEntry cse("SaveAnalysis"))
+    mpi::Comm comm = graph.Comm();
+    const int commSize = mpi::Size( comm );
+    const int commRank = mpi::Rank( comm );
+    const unsigned long long hash = GraphHash( graph );
+
+    std::ofstream file
+    ( RankFilename( basename, commRank ).c_str(), std::ios::binary );
+    if( !file.is_open() )
+        RuntimeError("Could not open analysis file for writing");
+    WriteBinary( file, analysisFileMagic );
+    WriteBinary( file, analysisFileVersion );
+    WriteBinary( file, commSize );
+    WriteBinary( file, commRank );
+    WriteBinary( file, hash );
+    WriteBinary( file, options );
+
+    // The reordering
+    WriteBinary( file, map.NumSources() );
+    WriteBinary( file, map.Map() );
+
+    // The separator tree (the communicators are rebuilt when loading)
+    const int numLocalSeps = sepTree.localSepsAndLeaves.size();
+    WriteBinary( file, numLocalSeps );
+    for( int s=0; s<numLocalSeps; ++s )
+    {
+        const SepOrLeaf& sepOrLeaf = *sepTree.localSepsAndLeaves[s];
+        WriteBinary( file, sepOrLeaf.parent );
+        WriteBinary( file, sepOrLeaf.off );
+        WriteBinary( file, sepOrLeaf.inds );
+    }
+    const int numDistSeps = sepTree.distSeps.size();
+    WriteBinary( file, numDistSeps );
+    for( int s=0; s<numDistSeps; ++s )
+    {
+        const DistSeparator& sep = sepTree.distSeps[s];
+        WriteBinary( file, sep.off );
+        WriteBinary( file, sep.inds );
+    }
+
+    // The full local symbolic analysis
+    const int numLocalNodes = info.localNodes.size();
+    WriteBinary( file, numLocalNodes );
+    for( int s=0; s<numLocalNodes; ++s )
+    {
+        const SymmNodeInfo& node = info.localNodes[s];
+        WriteBinary( file, node.size );
+        WriteBinary( file, node.off );
+        WriteBinary( file, node.parent );
+        WriteBinary( file, node.children );
+        WriteBinary( file, node.origLowerStruct );
+        WriteBinary( file, int(node.onLeft) );
+        WriteBinary( file, node.myOff );
+        WriteBinary( file, node.lowerStruct );
+        WriteBinary( file, node.origLowerRelInds );
+        WriteBinary( file, node.leftRelInds );
+        WriteBinary( file, node.rightRelInds );
+    }
+
+    // Only the input to the distributed part of the symbolic analysis
+    const int numDistNodes = info.distNodes.size();
+    WriteBinary( file, numDistNodes );
+    for( int s=0; s<numDistNodes; ++s )
+    {
+        const DistSymmNodeInfo& node = info.distNodes[s];
+        WriteBinary( file, node.size );
+        WriteBinary( file, node.off );
+        WriteBinary( file, int(node.onLeft) );
+        WriteBinary( file, node.origLowerStruct );
+    }
+
+    WriteBinary( file, info.amalgamation.numMerged );
+    WriteBinary( file, info.amalgamation.origEntries );
+    WriteBinary( file, info.amalgamation.extraEntries );
+    if( !file.good() )
+        RuntimeError("Could not write analysis file");
+}
+
+inline bool
+LoadAnalysis
+( const DistGraph& graph, DistMap& map, DistSeparatorTree& sepTree,
+  DistSymmInfo& info, std::string basename, const AnalysisOptions& options,
+  bool storeFactRecvInds )
+{
+    DEBUG_ONLY(CallStackEntry cse("LoadAnalysis"))
+    mpi::Comm comm = graph.Comm();
+    const int commSize = mpi::Size( comm );
+    const int commRank = mpi::Rank( comm );
+    const unsigned long long hash = GraphHash( graph );
+
+    // Read everything before modifying the outputs so that a bad file on any
+    // process leaves them untouched everywhere
+    int numSources=-1;
+    std::vector<int> localMap;
+    std::vector<SepOrLeaf> localSeps;
+    std::vector<DistSeparator> distSeps;
+    std::vector<SymmNodeInfo> localNodes;
+    std::vector<DistSymmNodeInfo> distNodes;
+    AmalgamationInfo amalgamation;
+    std::ifstream file
+    ( RankFilename( basename, commRank ).c_str(), std::ios::binary );
+    bool valid = file.is_open();
+    if( valid )
+    {
+        unsigned long long fileMagic=0, fileHash=0;
+        int fileVersion=-1, fileCommSize=-1, fileCommRank=-1;
+        ReadBinary( file, fileMagic );
+        ReadBinary( file, fileVersion );
+        ReadBinary( file, fileCommSize );
+        ReadBinary( file, fileCommRank );
+        ReadBinary( file, fileHash );
+        valid = file.good() && fileMagic == analysisFileMagic &&
+                fileVersion == analysisFileVersion &&
+                fileCommSize == commSize && fileCommRank == commRank &&
+                fileHash == hash && ReadAndMatch( file, options );
+    }
+    if( valid )
+    {
+        ReadBinary( file, numSources );
+        ReadBinary( file, localMap );
+
+        int numLocalSeps=0, numDistSeps=0;
+        ReadBinary( file, numLocalSeps );
+        if( file.good() && numLocalSeps > 0 )
+            localSeps.resize( numLocalSeps );
+        for( int s=0; s<numLocalSeps && file.good(); ++s )
+        {
+            SepOrLeaf& sepOrLeaf = localSeps[s];
+            ReadBinary( file, sepOrLeaf.parent );
+            ReadBinary( file, sepOrLeaf.off );
+            ReadBinary( file, sepOrLeaf.inds );
+        }
+        ReadBinary( file, numDistSeps );
+        if( file.good() && numDistSeps > 0 )
+            distSeps.resize( numDistSeps );
+        for( int s=0; s<numDistSeps && file.good(); ++s )
+        {
+            DistSeparator& sep = distSeps[s];
+            ReadBinary( file, sep.off );
+            ReadBinary( file, sep.inds );
+        }
+
+        int numLocalNodes=0, numDistNodes=0, onLeft=0;
+        ReadBinary( file, numLocalNodes );
+        if( file.good() && numLocalNodes > 0 )
+            localNodes.resize( numLocalNodes );
+        for( int s=0; s<numLocalNodes && file.good(); ++s )
+        {
+            SymmNodeInfo& node = localNodes[s];
+            ReadBinary( file, node.size );
+            ReadBinary( file, node.off );
+            ReadBinary( file, node.parent );
+            ReadBinary( file, node.children );
+            ReadBinary( file, node.origLowerStruct );
+            ReadBinary( file, onLeft );
+            node.onLeft = onLeft;
+            ReadBinary( file, node.myOff );
+            ReadBinary( file, node.lowerStruct );
+            ReadBinary( file, node.origLowerRelInds );
+            ReadBinary( file, node.leftRelInds );
+            ReadBinary( file, node.rightRelInds );
+        }
+        ReadBinary( file, numDistNodes );
+        if( file.good() && numDistNodes > 0 )
+            distNodes.resize( numDistNodes );
+        for( int s=0; s<numDistNodes && file.good(); ++s )
+        {
+            DistSymmNodeInfo& node = distNodes[s];
+            ReadBinary( file, node.size );
+            ReadBinary( file, node.off );
+            ReadBinary( file, onLeft );
+            node.onLeft = onLeft;
+            ReadBinary( file, node.origLowerStruct );
+        }
+
+        ReadBinary( file, amalgamation.numMerged );
+        ReadBinary( file, amalgamation.origEntries );
+        ReadBinary( file, amalgamation.extraEntries );
+        // The map is distributed the same way as the graph
+        valid = file.good() && numSources == graph.NumSources() &&
+                int(localMap.size()) == graph.NumLocalSources() &&
+                numLocalSeps > 0 && numLocalNodes == numLocalSeps &&
+                numDistNodes == numDistSeps+1 &&
+                numDistSeps == DistributedDepth( comm );
+    }
+    if( !mpi::AllReduce( int(valid), mpi::MIN, comm ) )
+        return false;
+
+    // The reordering
+    map.SetComm( comm );
+    map.Resize( numSources );
+    map.Map().swap( localMap );
+
+    // The local part of the separator tree
+    const int numLocalSeps = localSeps.size();
+    for( unsigned s=0; s<sepTree.localSepsAndLeaves.size(); ++s )
+        delete sepTree.localSepsAndLeaves[s];
+    sepTree.localSepsAndLeaves.resize( numLocalSeps );
+    for( int s=0; s<numLocalSeps; ++s )
+    {
+        sepTree.localSepsAndLeaves[s] = new SepOrLeaf;
+        sepTree.localSepsAndLeaves[s]->parent = localSeps[s].parent;
+        sepTree.localSepsAndLeaves[s]->off = localSeps[s].off;
+        sepTree.localSepsAndLeaves[s]->inds.swap( localSeps[s].inds );
+    }
+
+    // Rebuild the communicators of the distributed separators and nodes by
+    // repeating the team splits of BuildChildFromPerm, where the smaller team
+    // was assigned to the child whose side is recorded in 'onLeft'
+    for( unsigned s=0; s<sepTree.distSeps.size(); ++s )
+        mpi::Free( sepTree.distSeps[s].comm );
+    const int distDepth = distSeps.size();
+    sepTree.distSeps.resize( distDepth );
+    DistSymmElimTree eTree;
+    eTree.distNodes.resize( distDepth+1 );
+    mpi::Comm teamComm = comm;
+    for( int depth=0; depth<distDepth; ++depth )
+    {
+        DistSeparator& sep = sepTree.distSeps[distDepth-1-depth];
+        sep.off = distSeps[distDepth-1-depth].off;
+        sep.inds.swap( distSeps[distDepth-1-depth].inds );
+        mpi::Dup( teamComm, sep.comm );
+        mpi::Dup( teamComm, eTree.distNodes[distDepth-depth].comm );
+
+        const bool onLeft = distNodes[distDepth-depth-1].onLeft;
+        const int teamSize = mpi::Size( teamComm );
+        const int teamRank = mpi::Rank( teamComm );
+        const int smallTeamSize = teamSize/2;
+        const bool inSmallTeam = ( teamRank < smallTeamSize );
+        const bool smallOnLeft = ( inSmallTeam == onLeft );
+        const int childTeamOff =
+            ( smallOnLeft == onLeft ? 0 : smallTeamSize );
+        mpi::Comm childComm;
+        mpi::Split( teamComm, onLeft, teamRank-childTeamOff, childComm );
+        if( depth != 0 )
+            mpi::Free( teamComm );
+        teamComm = childComm;
+    }
+    mpi::Dup( teamComm, eTree.distNodes[0].comm );
+    if( distDepth != 0 )
+        mpi::Free( teamComm );
+    for( int s=0; s<=distDepth; ++s )
+    {
+        DistSymmNode& node = eTree.distNodes[s];
+        node.onLeft = distNodes[s].onLeft;
+        node.size = distNodes[s].size;
+        node.off = distNodes[s].off;
+        node.lowerStruct.swap( distNodes[s].origLowerStruct );
+    }
+
+    // Restore the local analysis and then redo the distributed analysis,
+    // which builds the process grids and communication metadata
+    info.EmptyDistNodes();
+    info.localNodes.swap( localNodes );
+    const int numLocalNodes = info.localNodes.size();
+    for( int s=0; s<numLocalNodes; ++s )
+    {
+        // The runs of the relative indices are cheap to recompute
+        SymmNodeInfo& node = info.localNodes[s];
+        if( node.children.size() == 2 )
+        {
+            ContiguousRuns( node.leftRunStarts, node.leftRelInds );
+            ContiguousRuns( node.rightRunStarts, node.rightRelInds );
+        }
+    }
+    info.amalgamation = amalgamation;
+    DistSymmetricAnalysis( eTree, info, storeFactRecvInds );
+    return true;
+}
+
+} // namespace cliq
+
+#endif // ifndef CLIQ_IO_SAVEANALYSIS_HPP
@@ -0,0 +1,427 @@
+/*
+   Copyright (c) 2009-2014, Jack Poulson, Lexing Ying,
+   The University of Texas at Austin, Stanford University, and the
+   Georgia Insitute of Technology.
+   All rights reserved.
+ 
+   This file is part of Clique and is under the BSD 2-Clause License, 
+   which can be found in the LICENSE file in the root directory, or at 
+   http://opensource.org/licenses/BSD-2-Clause
+*/
+#pragma once
+#ifndef CLIQ_IO_SAVEFACTORIZATION_HPP
+#define CLIQ_IO_SAVEFACTORIZATION_HPP
+
+namespace cliq {
+
+// Write the factored fronts of L into one binary file per process, named
+// "<basename>.<commRank>". The local block of each piece of each front (the
+// lower-left piece of the front, its diagonal and subdiagonal, and its
+// pivots) is stored contiguously and aligned so that the file can be mapped
+// into memory by AttachFactorization. The AnalysisHash of 'info' is stored 
+// in the header.
+template<typename F>
+void SaveFactorization
+( const DistSymmInfo& info, const DistSymmFrontTree<F>& L,
+  std::string basename );
+
+// Map the files written by SaveFactorization and make the fronts of L
+// read-only views into them, so that the cost does not grow with the size of
+// the factorization (the fronts are paged in as the solves touch them). The
+// symbolic analysis must be the one which the factorization was computed
+// with (e.g., as recovered by LoadAnalysis), which is checked against the
+// hash stored by SaveFactorization. If any process could not map a matching
+// file, then false is returned on every process and L is not modified. L
+// must be reinitialized before it can be refactored.
+template<typename F>
+bool AttachFactorization
+( const DistSymmInfo& info, DistSymmFrontTree<F>& L, std::string basename );
+
+//----------------------------------------------------------------------------//
+// Implementation begins here                                                 //
+//----------------------------------------------------------------------------//
+
+// "CLIQFACT" and the version of the file layout
+const unsigned long long factorFileMagic = 0x5443414651494c43ULL;
+const int factorFileVersion = 2;
+
+// Each block begins at a multiple of this many bytes within the file
+const int factorFileAlignment = 64;
+
+// The pieces of each front are stored in the order L, diag, subdiag, piv
+const int numFrontPieces = 4;
+
+// The position within the file and the distribution of the local block of a
+// piece of a front
+struct FactorBlock
+{
+    unsigned long long offset;
+    int height, width, localHeight, localWidth, colAlign, rowAlign;
+};
+
+template<typename T>
+inline FactorBlock
+DescribeBlock( const Matrix<T>& A )
+{
+    FactorBlock block;
+    block.offset = 0;
+    block.height = block.localHeight = A.Height();
+    block.width = block.localWidth = A.Width();
+    block.colAlign = block.rowAlign = 0;
+    return block;
+}
+
+template<typename T,Dist U,Dist V>
+inline FactorBlock
+DescribeBlock( const DistMatrix<T,U,V>& A )
+{
+    FactorBlock block;
+    block.offset = 0;
+    block.height = A.Height();
+    block.width = A.Width();
+    block.localHeight = A.LocalHeight();
+    block.localWidth = A.LocalWidth();
+    block.colAlign = A.ColAlign();
+    block.rowAlign = A.RowAlign();
+    return block;
+}
+
+template<typename T>
+inline void
+WriteBlock
+( std::ofstream& file, const FactorBlock& block, const T* buffer, int ldim )
+{
+    // Pad up to the start of the block
+    const std::size_t pos = file.tellp();
+    if( pos < block.offset )
+    {
+        const std::vector<char> padding( block.offset-pos, 0 );
+        file.write( &padding[0], padding.size() );
+    }
+    for( int j=0; j<block.localWidth; ++j )
+        file.write
+        ( reinterpret_cast<const char*>(&buffer[j*ldim]),
+          block.localHeight*sizeof(T) );
+}
+
+template<typename T>
+inline void
+AttachBlock( Matrix<T>& A, const FactorBlock& block, const byte* map )
+{
+    A.LockedAttach
+    ( block.height, block.width,
+      reinterpret_cast<const T*>(&map[block.offset]),
+      std::max(block.localHeight,1) );
+}
+
+template<typename T,Dist U,Dist V>
+inline void
+AttachBlock
+( DistMatrix<T,U,V>& A, const FactorBlock& block, const Grid& grid,
+  const byte* map )
+{
+    A.LockedAttach
+    ( block.height, block.width, grid, block.colAlign, block.rowAlign,
+      reinterpret_cast<const T*>(&map[block.offset]),
+      std::max(block.localHeight,1) );
+}
+
+template<typename F>
+inline void
+SaveFactorization
+( const DistSymmInfo& info, const DistSymmFrontTree<F>& L,
+  std::string basename )
+{
+    DEBUG_ONLY(CallStackEntry cse("SaveFactorization"))
+    if( Unfactored(L.frontType) )
+        LogicError("The fronts have not been factored");
+    mpi::Comm comm = info.distNodes.back().comm;
+    const int commSize = mpi::Size( comm );
+    const int commRank = mpi::Rank( comm );
+    const unsigned long long hash = AnalysisHash( info );
+    const bool frontsAre1d = FrontsAre1d( L.frontType );
+    const int numLocal = L.localFronts.size();
+    const int numDist = L.distFronts.size();
+    const int numFronts = numLocal + numDist - 1;
+
+    // Lay out the pieces of the local fronts followed by those of the
+    // distributed fronts (other than the leaf, which views the top local front)
+    std::vector<FactorBlock> blocks;
+    blocks.reserve( numFrontPieces*numFronts );
+    for( int s=0; s<numLocal; ++s )
+    {
+        const SymmFront<F>& front = L.localFronts[s];
+        blocks.push_back( DescribeBlock(front.frontL) );
+        blocks.push_back( DescribeBlock(front.diag) );
+        blocks.push_back( DescribeBlock(front.subdiag) );
+        blocks.push_back( DescribeBlock(front.piv) );
+    }
+    for( int s=1; s<numDist; ++s )
+    {
+        const DistSymmFront<F>& front = L.distFronts[s];
+        if( frontsAre1d )
+            blocks.push_back( DescribeBlock(front.front1dL) );
+        else
+            blocks.push_back( DescribeBlock(front.front2dL) );
+        blocks.push_back( DescribeBlock(front.diag1d) );
+        blocks.push_back( DescribeBlock(front.subdiag1d) );
+        blocks.push_back( DescribeBlock(front.piv) );
+    }
+    const int numBlocks = blocks.size();
+    const std::size_t blockInfoSize =
+        sizeof(unsigned long long) + 6*sizeof(int);
+    std::size_t pos =
+        2*sizeof(unsigned long long) + 9*sizeof(int) + 
+        numBlocks*blockInfoSize;
+    for( int k=0; k<numBlocks; ++k )
+    {
+        FactorBlock& block = blocks[k];
+        const std::size_t entrySize =
+            ( k % numFrontPieces == 3 ? sizeof(Int) : sizeof(F) );
+        block.offset =
+            ((pos+factorFileAlignment-1)/factorFileAlignment)*
+            factorFileAlignment;
+        pos = block.offset +
+              std::size_t(block.localHeight)*block.localWidth*entrySize;
+    }
+
+    const std::string filename = RankFilename( basename, commRank );
+    std::ofstream file( filename.c_str(), std::ios::binary );
+    if( !file.is_open() )
+        RuntimeError("Could not open ",filename);
+    WriteBinary( file, factorFileMagic );
+    WriteBinary( file, factorFileVersion );
+    WriteBinary( file, int(sizeof(F)) );
+    WriteBinary( file, int(sizeof(Int)) );
+    WriteBinary( file, commSize );
+    WriteBinary( file, commRank );
+    WriteBinary( file, hash );
+    WriteBinary( file, int(L.isHermitian) );
+    WriteBinary( file, int(L.frontType) );
+    WriteBinary( file, numLocal );
+    WriteBinary( file, numDist );
+    for( int k=0; k<numBlocks; ++k )
+    {
+        const FactorBlock& block = blocks[k];
+        WriteBinary( file, block.offset );
+        WriteBinary( file, block.height );
+        WriteBinary( file, block.width );
+        WriteBinary( file, block.localHeight );
+        WriteBinary( file, block.localWidth );
+        WriteBinary( file, block.colAlign );
+        WriteBinary( file, block.rowAlign );
+    }
+
+    // Out-of-core fronts are read back in one at a time
+    const FactorBlock* block = &blocks[0];
+    for( int s=0; s<numLocal; ++s )
+    {
+        L.FetchLocalFront( s );
+        const SymmFront<F>& front = L.localFronts[s];
+        WriteBlock
+        ( file, *block++, front.frontL.LockedBuffer(), front.frontL.LDim() );
+        WriteBlock
+        ( file, *block++, front.diag.LockedBuffer(), front.diag.LDim() );
+        WriteBlock
+        ( file, *block++, front.subdiag.LockedBuffer(),
+          front.subdiag.LDim() );
+        WriteBlock
+        ( file, *block++, front.piv.LockedBuffer(), front.piv.LDim() );
+    }
+    for( int s=1; s<numDist; ++s )
+    {
+        L.FetchDistFront( s );
+        const DistSymmFront<F>& front = L.distFronts[s];
+        if( frontsAre1d )
+            WriteBlock
+            ( file, *block++, front.front1dL.LockedBuffer(),
+              front.front1dL.LDim() );
+        else
+            WriteBlock
+            ( file, *block++, front.front2dL.LockedBuffer(),
+              front.front2dL.LDim() );
+        WriteBlock
+        ( file, *block++, front.diag1d.LockedBuffer(), front.diag1d.LDim() );
+        WriteBlock
+        ( file, *block++, front.subdiag1d.LockedBuffer(),
+          front.subdiag1d.LDim() );
+        WriteBlock
+        ( file, *block++, front.piv.LockedBuffer(), front.piv.LDim() );
+    }
+    if( !file.good() )
+        RuntimeError("Could not write ",filename);
+}
+
+template<typename F>
+inline bool
+AttachFactorization
+( const DistSymmInfo& info, DistSymmFrontTree<F>& L, std::string basename )
+{
+    DEBUG_ONLY(CallStackEntry cse("AttachFactorization"))
+    mpi::Comm comm = info.distNodes.back().comm;
+    const int commSize = mpi::Size( comm );
+    const int commRank = mpi::Rank( comm );
+    const int numLocal = info.localNodes.size();
+    const int numDist = info.distNodes.size();
+    const int numFronts = numLocal + numDist - 1;
+    const int numBlocks = numFrontPieces*numFronts;
+    const unsigned long long hash = AnalysisHash( info );
+
+    // Read the layout and check it against the analysis before mapping
+    const std::string filename = RankFilename( basename, commRank );
+    int isHermitian=0, frontType=-1;
+    std::vector<FactorBlock> blocks;
+    std::ifstream file( filename.c_str(), std::ios::binary );
+    bool valid = file.is_open();
+    if( valid )
+    {
+        unsigned long long fileMagic=0, fileHash=0;
+        int fileVersion=-1, entrySize=-1, intSize=-1,
+            fileCommSize=-1, fileCommRank=-1, fileNumLocal=-1, fileNumDist=-1;
+        ReadBinary( file, fileMagic );
+        ReadBinary( file, fileVersion );
+        ReadBinary( file, entrySize );
+        ReadBinary( file, intSize );
+        ReadBinary( file, fileCommSize );
+        ReadBinary( file, fileCommRank );
+        ReadBinary( file, fileHash );
+        ReadBinary( file, isHermitian );
+        ReadBinary( file, frontType );
+        ReadBinary( file, fileNumLocal );
+        ReadBinary( file, fileNumDist );
+        valid = file.good() && fileMagic == factorFileMagic &&
+                fileVersion == factorFileVersion &&
+                entrySize == int(sizeof(F)) && intSize == int(sizeof(Int)) &&
+                fileCommSize == commSize && fileCommRank == commRank &&
+                fileHash == hash &&
+                fileNumLocal == numLocal && fileNumDist == numDist &&
+                frontType >= LDL_1D && frontType <= BLOCK_LDL_INTRAPIV_2D;
+    }
+    if( valid )
+    {
+        blocks.resize( numBlocks );
+        for( int k=0; k<numBlocks; ++k )
+        {
+            FactorBlock& block = blocks[k];
+            ReadBinary( file, block.offset );
+            ReadBinary( file, block.height );
+            ReadBinary( file, block.width );
+            ReadBinary( file, block.localHeight );
+            ReadBinary( file, block.localWidth );
+            ReadBinary( file, block.colAlign );
+            ReadBinary( file, block.rowAlign );
+        }
+        valid = file.good();
+    }
+    if( valid )
+    {
+        file.seekg( 0, std::ios::end );
+        const std::size_t fileSize = file.tellg();
+        for( int k=0; k<numBlocks; ++k )
+        {
+            const FactorBlock& block = blocks[k];
+            const std::size_t entrySize =
+                ( k % numFrontPieces == 3 ? sizeof(Int) : sizeof(F) );
+            if( block.localHeight < 0 || block.localWidth < 0 ||
+                block.offset % factorFileAlignment != 0 ||
+                block.offset + std::size_t(block.localHeight)*
+                block.localWidth*entrySize > fileSize )
+                valid = false;
+        }
+        // The fronts must have the sizes implied by the analysis
+        for( int f=0; f<numFronts; ++f )
+        {
+            const FactorBlock& block = blocks[f*numFrontPieces];
+            int size, lowerSize;
+            if( f < numLocal )
+            {
+                size = info.localNodes[f].size;
+                lowerSize = info.localNodes[f].lowerStruct.size();
+            }
+            else
+            {
+                size = info.distNodes[f-numLocal+1].size;
+                lowerSize = info.distNodes[f-numLocal+1].lowerStruct.size();
+            }
+            if( block.height != size+lowerSize || block.width != size )
+                valid = false;
+        }
+    }
+    file.close();
+
+    // Map the file before voting so that a failure on any process leaves L
+    // untouched everywhere
+    const byte* map = 0;
+    std::size_t mapSize = 0;
+    if( valid )
+    {
+        map = MapFile( filename, mapSize );
+        valid = ( map != 0 );
+    }
+    if( !mpi::AllReduce( int(valid), mpi::MIN, comm ) )
+    {
+        if( map != 0 )
+            UnmapFile( map, mapSize );
+        return false;
+    }
+
+    // Replace the fronts with views into the mapped file
+    L.frontStore.Close();
+    SwapClear( L.localFronts );
+    SwapClear( L.distFronts );
+    L.fillMeta.Empty();
+    L.frontStore.AdoptMap( map, mapSize );
+    L.isHermitian = isHermitian;
+    L.frontType = static_cast<SymmFrontType>(frontType);
+    const bool frontsAre1d = FrontsAre1d( L.frontType );
+    L.localFronts.resize( numLocal );
+    L.distFronts.resize( numDist );
+    const FactorBlock* block = &blocks[0];
+    for( int s=0; s<numLocal; ++s )
+    {
+        SymmFront<F>& front = L.localFronts[s];
+        AttachBlock( front.frontL, *block++, map );
+        AttachBlock( front.diag, *block++, map );
+        AttachBlock( front.subdiag, *block++, map );
+        AttachBlock( front.piv, *block++, map );
+    }
+    for( int s=1; s<numDist; ++s )
+    {
+        const Grid& grid = *info.distNodes[s].grid;
+        DistSymmFront<F>& front = L.distFronts[s];
+        if( frontsAre1d )
+            AttachBlock( front.front1dL, *block++, grid, map );
+        else
+            AttachBlock( front.front2dL, *block++, grid, map );
+        AttachBlock( front.diag1d, *block++, grid, map );
+        AttachBlock( front.subdiag1d, *block++, grid, map );
+        AttachBlock( front.piv, *block++, grid, map );
+    }
+
+    // The distributed leaf views the top local front (as in DistLDL)
+    const SymmFront<F>& topLocFront = L.localFronts.back();
+    DistSymmFront<F>& botDistFront = L.distFronts[0];
+    const Grid& botGrid = *info.distNodes[0].grid;
+    if( frontsAre1d )
+        botDistFront.front1dL.LockedAttach
+        ( topLocFront.frontL.Height(), topLocFront.frontL.Width(), botGrid,
+          0, 0, topLocFront.frontL );
+    else
+        botDistFront.front2dL.LockedAttach
+        ( topLocFront.frontL.Height(), topLocFront.frontL.Width(), botGrid,
+          0, 0, topLocFront.frontL );
+    botDistFront.diag1d.LockedAttach
+    ( topLocFront.diag.Height(), topLocFront.diag.Width(), botGrid, 0, 0,
+      topLocFront.diag );
+    botDistFront.subdiag1d.LockedAttach
+    ( topLocFront.subdiag.Height(), topLocFront.subdiag.Width(), botGrid,
+      0, 0, topLocFront.subdiag );
+    botDistFront.piv.LockedAttach
+    ( topLocFront.piv.Height(), topLocFront.piv.Width(), botGrid, 0, 0,
+      topLocFront.piv );
+    return true;
+}
+
+} // namespace cliq
+
+#endif // ifndef CLIQ_IO_SAVEFACTORIZATION_HPP
@@ -32,6 +32,8 @@ inline void ChangeFrontType( DistSymmFrontTree<F>& L, SymmFrontType frontType )
         return;
     const int numDistNodes = L.distFronts.size();    
     const SymmFrontType oldFrontType = L.frontType;
+    if( L.frontStore.Offloaded(L.localFronts.size()) )
+        LogicError("Cannot change the type of out-of-core fronts");
     DistSymmFront<F>& leafFront = L.distFronts[0];
 
     if( frontType == ConvertTo2d(oldFrontType) )
@@ -64,15 +64,16 @@ DistNodalMultiVec<F>::operator=( const DistNodalMatrix<F>& X )
     return *this;
 }
 
-template<typename F>
+// Determine which rows of a DistMultiVec (in the original ordering) each
+// process needs for its portion of the nodal distribution
 inline void
-DistNodalMultiVec<F>::Pull
-( const DistMap& inverseMap, const DistSymmInfo& info,
-  const DistMultiVec<F>& X )
+BuildNodalRedistMeta
+( const DistMap& inverseMap, const DistSymmInfo& info, mpi::Comm comm, 
+  int height, int blocksize, int firstLocalRow )
 {
-    DEBUG_ONLY(CallStackEntry cse("DistNodalMultiVec::Pull"))
-    height_ = X.Height();
-    width_ = X.Width();
+    DEBUG_ONLY(CallStackEntry cse("BuildNodalRedistMeta"))
+    NodalRedistMeta& meta = info.redistMeta;
+    meta.Empty();
 
     // Traverse our part of the elimination tree to see how many indices we need
     int numRecvInds=0;
@@ -112,10 +113,8 @@ DistNodalMultiVec<F>::Pull
     inverseMap.Translate( mappedInds );
 
     // Figure out how many entries each process owns that we need
-    mpi::Comm comm = X.Comm();
     const int commSize = mpi::Size( comm );
     std::vector<int> recvSizes( commSize, 0 );
-    const int blocksize = X.Blocksize();
     for( int s=0; s<numRecvInds; ++s )
     {
         const int i = mappedInds[s];
@@ -131,12 +130,16 @@ DistNodalMultiVec<F>::Pull
     }
     std::vector<int> recvInds( numRecvInds );
     std::vector<int> offs = recvOffs;
+    meta.nodalOffs.resize( numRecvInds );
     for( int s=0; s<numRecvInds; ++s )
     {
         const int i = mappedInds[s];
         const int q = RowToProcess( i, blocksize, commSize );
+        meta.nodalOffs[s] = offs[q];
         recvInds[offs[q]++] = i;
     }
+    SwapClear( mappedInds );
+    SwapClear( offs );
 
     // Coordinate for the coming AllToAll to exchange the indices of X
     std::vector<int> sendSizes( commSize );
@@ -150,37 +153,64 @@ DistNodalMultiVec<F>::Pull
     }
 
     // Request the indices
-    std::vector<int> sendInds( numSendInds );
+    meta.ownedRows.resize( numSendInds );
     mpi::AllToAll
     ( &recvInds[0], &recvSizes[0], &recvOffs[0],
-      &sendInds[0], &sendSizes[0], &sendOffs[0], comm );
+      &meta.ownedRows[0], &sendSizes[0], &sendOffs[0], comm );
+    for( int s=0; s<numSendInds; ++s )
+    {
+        meta.ownedRows[s] -= firstLocalRow;
+        DEBUG_ONLY(
+            if( meta.ownedRows[s] < 0 )
+                LogicError("Requested a row which is not owned");
+        )
+    }
+
+    meta.ownedCounts = sendSizes;
+    meta.nodalCounts = recvSizes;
+    meta.mapVersion = inverseMap.Version();
+    meta.height = height;
+}
+
+template<typename F>
+inline void
+DistNodalMultiVec<F>::Pull
+( const DistMap& inverseMap, const DistSymmInfo& info,
+  const DistMultiVec<F>& X )
+{
+    DEBUG_ONLY(CallStackEntry cse("DistNodalMultiVec::Pull"))
+    height_ = X.Height();
+    width_ = X.Width();
+
+    // Exchange over the (congruent) communicator of the analysis, which owns
+    // the cached plans
+    mpi::Comm comm = info.distNodes.back().comm;
+    DEBUG_ONLY(
+        if( !mpi::Congruent( X.Comm(), comm ) )
+            LogicError("X's communicator was not congruent with the analysis");
+    )
+    NodalRedistMeta& meta = info.redistMeta;
+    if( !meta.Matches( inverseMap, height_, comm ) )
+        BuildNodalRedistMeta
+        ( inverseMap, info, comm, height_, X.Blocksize(), X.FirstLocalRow() );
+    CommPlan& plan = meta.pullPlan;
+    if( !plan.Ready<F>( comm, width_ ) )
+        plan.Setup<F>( meta.ownedCounts, meta.nodalCounts, comm, width_ );
 
     // Fulfill the requests
-    std::vector<F> sendVals( numSendInds*width_ );
-    const int firstLocalRow = X.FirstLocalRow();
+    F* sendVals = plan.SendBuffer<F>();
+    const int numSendInds = meta.ownedRows.size();
     for( int s=0; s<numSendInds; ++s )
         for( int j=0; j<width_; ++j )
-            sendVals[s*width_+j] = X.GetLocal( sendInds[s]-firstLocalRow, j );
+            sendVals[s*width_+j] = X.GetLocal( meta.ownedRows[s], j );
 
     // Reply with the values
-    std::vector<F> recvVals( numRecvInds*width_ );
-    for( int q=0; q<commSize; ++q )
-    {
-        sendSizes[q] *= width_;
-        sendOffs[q] *= width_;
-        recvSizes[q] *= width_;
-        recvOffs[q] *= width_;
-    }
-    mpi::AllToAll
-    ( &sendVals[0], &sendSizes[0], &sendOffs[0],
-      &recvVals[0], &recvSizes[0], &recvOffs[0], comm );
-    SwapClear( sendVals );
-    SwapClear( sendSizes );
-    SwapClear( sendOffs );
+    plan.Exchange();
+    const F* recvVals = plan.LockedRecvBuffer<F>();
 
     // Unpack the values
-    off = 0;
-    offs = recvOffs;
+    int off = 0;
+    const int numLocal = info.localNodes.size();
     localNodes.resize( numLocal );
     for( int s=0; s<numLocal; ++s )
     {
@@ -188,12 +218,12 @@ DistNodalMultiVec<F>::Pull
         localNodes[s].Resize( nodeInfo.size, width_ );
         for( int t=0; t<nodeInfo.size; ++t )
         {
-            const int i = mappedInds[off++];
-            const int q = RowToProcess( i, blocksize, commSize );
+            const F* recvRow = &recvVals[meta.nodalOffs[off++]*width_];
             for( int j=0; j<width_; ++j )
-                localNodes[s].Set( t, j, recvVals[offs[q]++] );
+                localNodes[s].Set( t, j, recvRow[j] );
         }
     }
+    const int numDist = info.distNodes.size();
     distNodes.resize( numDist-1 );
     for( int s=1; s<numDist; ++s )
     {
@@ -204,14 +234,13 @@ DistNodalMultiVec<F>::Pull
         const int localHeight = XNode.LocalHeight();
         for( int tLoc=0; tLoc<localHeight; ++tLoc )
         {
-            const int i = mappedInds[off++];
-            const int q = RowToProcess( i, blocksize, commSize );
+            const F* recvRow = &recvVals[meta.nodalOffs[off++]*width_];
             for( int j=0; j<width_; ++j )
-                XNode.SetLocal( tLoc, j, recvVals[offs[q]++] );
+                XNode.SetLocal( tLoc, j, recvRow[j] );
         }
     }
     DEBUG_ONLY(
-        if( off != numRecvInds )
+        if( off != int(meta.nodalOffs.size()) )
             LogicError("Unpacked wrong number of indices");
     )
 }
@@ -230,126 +259,56 @@ DistNodalMultiVec<F>::Push
     X.SetComm( comm );
     X.Resize( height, width );
 
-    const int commSize = mpi::Size( comm );
-    const int blocksize = X.Blocksize();
-    const int firstLocalRow = X.FirstLocalRow();
-    const int numDist = info.distNodes.size();
-    const int numLocal = info.localNodes.size();
+    NodalRedistMeta& meta = info.redistMeta;
+    if( !meta.Matches( inverseMap, height, comm ) )
+        BuildNodalRedistMeta
+        ( inverseMap, info, comm, height, X.Blocksize(), X.FirstLocalRow() );
+    DEBUG_ONLY(
+        if( int(meta.nodalOffs.size()) != LocalHeight() )
+            LogicError("Nodal multivector did not match the symbolic info");
+        if( int(meta.ownedRows.size()) != X.LocalHeight() )
+            LogicError("Number of owned rows was not equal to local height");
+    )
+    CommPlan& plan = meta.pushPlan;
+    if( !plan.Ready<F>( comm, width ) )
+        plan.Setup<F>( meta.nodalCounts, meta.ownedCounts, comm, width );
 
-    // Fill the set of indices that we need to map to the original ordering
-    const int numSendInds = LocalHeight();
+    // Pack the send values
     int off=0;
-    std::vector<int> mappedInds( numSendInds );
-    for( int s=0; s<numLocal; ++s )
-    {
-        const SymmNodeInfo& nodeInfo = info.localNodes[s];
-        for( int t=0; t<nodeInfo.size; ++t )
-            mappedInds[off++] = nodeInfo.off+t;
-    }
-    for( int s=1; s<numDist; ++s )
-    {
-        const DistSymmNodeInfo& nodeInfo = info.distNodes[s];
-        const DistMatrix<F,VC,STAR>& XNode = distNodes[s-1];
-        for( int t=XNode.ColShift(); t<XNode.Height(); t+=XNode.ColStride() )
-            mappedInds[off++] = nodeInfo.off+t;
-    }
-
-    // Convert the indices to the original ordering
-    inverseMap.Translate( mappedInds );
-
-    // Figure out how many indices each process owns that we need to send
-    std::vector<int> sendSizes( commSize, 0 );
-    for( int s=0; s<numSendInds; ++s )
-    {
-        const int i = mappedInds[s];
-        const int q = RowToProcess( i, blocksize, commSize );
-        ++sendSizes[q];
-    }
-    std::vector<int> sendOffs( commSize );
-    off=0;
-    for( int q=0; q<commSize; ++q )
-    {
-        sendOffs[q] = off;
-        off += sendSizes[q];
-    }
-
-    // Pack the send indices and values
-    off=0;
-    std::vector<F> sendVals( numSendInds*width );
-    std::vector<int> sendInds( numSendInds );
-    std::vector<int> offs = sendOffs;
+    F* sendVals = plan.SendBuffer<F>();
+    const int numLocal = info.localNodes.size();
     for( int s=0; s<numLocal; ++s )
     {
         const SymmNodeInfo& nodeInfo = info.localNodes[s];
         for( int t=0; t<nodeInfo.size; ++t )
         {
-            const int i = mappedInds[off++];
-            const int q = RowToProcess( i, blocksize, commSize );
+            F* sendRow = &sendVals[meta.nodalOffs[off++]*width];
             for( int j=0; j<width; ++j )
-                sendVals[offs[q]*width+j] = localNodes[s].Get(t,j);    
-            sendInds[offs[q]++] = i;
+                sendRow[j] = localNodes[s].Get(t,j);    
         }
     }
+    const int numDist = info.distNodes.size();
     for( int s=1; s<numDist; ++s )
     {
         const DistMatrix<F,VC,STAR>& XNode = distNodes[s-1];
         const int localHeight = XNode.LocalHeight();
         for( int tLoc=0; tLoc<localHeight; ++tLoc )
         {
-            const int i = mappedInds[off++];
-            const int q = RowToProcess( i, blocksize, commSize );
+            F* sendRow = &sendVals[meta.nodalOffs[off++]*width];
             for( int j=0; j<width; ++j )
-                sendVals[offs[q]*width+j] = XNode.GetLocal(tLoc,j);
-            sendInds[offs[q]++] = i;
+                sendRow[j] = XNode.GetLocal(tLoc,j);
         }
     }
 
-    // Coordinate for the coming AllToAll to exchange the indices of x
-    std::vector<int> recvSizes( commSize );
-    mpi::AllToAll( &sendSizes[0], 1, &recvSizes[0], 1, comm );
-    int numRecvInds=0;
-    std::vector<int> recvOffs( commSize );
-    for( int q=0; q<commSize; ++q )
-    {
-        recvOffs[q] = numRecvInds;
-        numRecvInds += recvSizes[q];
-    }
-    DEBUG_ONLY(
-        if( numRecvInds != X.LocalHeight() )
-            LogicError("numRecvInds was not equal to local height");
-    )
-
-    // Send the indices
-    std::vector<int> recvInds( numRecvInds );
-    mpi::AllToAll
-    ( &sendInds[0], &sendSizes[0], &sendOffs[0],
-      &recvInds[0], &recvSizes[0], &recvOffs[0], comm );
-
     // Send the values
-    std::vector<F> recvVals( numRecvInds*width );
-    for( int q=0; q<commSize; ++q )
-    {
-        sendSizes[q] *= width;
-        sendOffs[q] *= width;
-        recvSizes[q] *= width;
-        recvOffs[q] *= width;
-    }
-    mpi::AllToAll
-    ( &sendVals[0], &sendSizes[0], &sendOffs[0],
-      &recvVals[0], &recvSizes[0], &recvOffs[0], comm );
-    SwapClear( sendVals );
-    SwapClear( sendSizes );
-    SwapClear( sendOffs );
+    plan.Exchange();
+    const F* recvVals = plan.LockedRecvBuffer<F>();
 
     // Unpack the values
+    const int numRecvInds = meta.ownedRows.size();
     for( int s=0; s<numRecvInds; ++s )
     {
-        const int i = recvInds[s];
-        const int iLocal = i - firstLocalRow;
-        DEBUG_ONLY(
-            if( iLocal < 0 || iLocal >= X.LocalHeight() )
-                LogicError("iLocal was out of bounds");
-        )
+        const int iLocal = meta.ownedRows[s];
         for( int j=0; j<width; ++j )
             X.SetLocal( iLocal, j, recvVals[s*width+j] );
     }
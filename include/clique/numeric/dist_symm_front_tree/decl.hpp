@@ -203,6 +203,45 @@ struct DistSymmFront
     mutable DistMatrix<F> work2d;
 };
 
+// The pattern for filling the fronts from the entries of a sparse matrix, 
+// which is kept by DistSymmFrontTree::Initialize (if requested) so that the
+// fronts can be refilled from a matrix with the same sparsity pattern and new
+// values
+struct FrontFillMeta
+{
+    bool ready, conjugate;
+    int numLocalEntries;
+
+    // The local index (within the sparse matrix) of each value that we send,
+    // ordered by destination process. Values which would be discarded by 
+    // their destination (e.g., upper-triangular entries) are not sent.
+    std::vector<int> sendEntryInds;
+
+    // The front which each received value belongs to (local fronts are 
+    // numbered first, followed by the distributed fronts, excluding the 
+    // distributed leaf), and its local row and column within that front
+    std::vector<int> recvFronts, recvLocalRows, recvLocalCols;
+
+    // The dimensions of each front (numbered as above)
+    std::vector<int> frontHeights, frontWidths;
+
+    CommPlan plan;
+
+    FrontFillMeta() : ready(false), conjugate(false), numLocalEntries(0) { }
+
+    void Empty()
+    {
+        ready = false;
+        SwapClear( sendEntryInds );
+        SwapClear( recvFronts );
+        SwapClear( recvLocalRows );
+        SwapClear( recvLocalCols );
+        SwapClear( frontHeights );
+        SwapClear( frontWidths );
+        plan.Empty();
+    }
+};
+
 template<typename F>
 struct DistSymmFrontTree
 {
@@ -210,6 +249,22 @@ struct DistSymmFrontTree
     SymmFrontType frontType;
     std::vector<SymmFront<F>> localFronts;
     std::vector<DistSymmFront<F>> distFronts;
+    FrontFillMeta fillMeta;
+
+    // The fronts are numbered as in FrontFillMeta (local fronts first, then
+    // the distributed fronts other than the leaf)
+    mutable FrontStore<F> frontStore;
+
+    // The workspaces of the local fronts during the solves are views into
+    // this arena, which is sized by the first solve with a given number of
+    // right-hand sides (or by an explicit call to solveArena.Reserve) and 
+    // then reused
+    mutable SolveArena<F> solveArena;
+
+    // The update matrices of the local fronts during a sequential 
+    // factorization are views into this stack, which is sized by LDL and then
+    // freed once the distributed factorization has consumed the last update
+    UpdateArena<F> updateArena;
 
     DistSymmFrontTree();
 
@@ -218,14 +273,37 @@ struct DistSymmFrontTree
       const DistMap& reordering,
       const DistSeparatorTree& sepTree,
       const DistSymmInfo& info,
-      bool conjugate=false );
+      bool conjugate=false, bool keepRefactorMeta=true );
 
     void Initialize
     ( const DistSparseMatrix<F>& A,
       const DistMap& reordering,
       const DistSeparatorTree& sepTree,
       const DistSymmInfo& info,
-      bool conjugate=false );
+      bool conjugate=false, bool keepRefactorMeta=true );
+
+    // Refill the fronts with the values of a matrix with the same sparsity 
+    // pattern (and distribution) as the one passed to Initialize, which 
+    // avoids recomputing the redistribution. Since the fill pattern requires
+    // several integers per entry of the fronts, Initialize can be told not to
+    // keep it (by setting 'keepRefactorMeta' to false), in which case Refactor
+    // is unavailable. The front type is reset to SYMM_2D so that LDL may then
+    // be called.
+    void Refactor( const DistSparseMatrix<F>& A );
+
+    // Write each factored front (other than the top local front, whose
+    // storage is shared with the distributed leaf) to the file
+    // '<basename>.<rank>' and stream the fronts back in, one at a time, during
+    // the solves. The local fronts are written as soon as they are factored,
+    // and the distributed fronts once they have been converted to their final
+    // type. This must be called after Initialize and before LDL.
+    void SetOutOfCore( const std::string& basename );
+    bool OutOfCore() const;
+
+    // Make the lower-left piece of the given front resident (if it was written
+    // out) and begin prefetching the next one in the order of traversal
+    void FetchLocalFront( int s ) const;
+    void FetchDistFront( int s ) const;
 
     void TopLeftMemoryInfo
     ( double& numLocalEntries, double& minLocalEntries, double& maxLocalEntries,
@@ -239,6 +317,14 @@ struct DistSymmFrontTree
     ( double& numLocalEntries, double& minLocalEntries, double& maxLocalEntries,
       double& numGlobalEntries ) const;
 
+    // The same as MemoryInfo, but with the peak size of the local update stack
+    // during the last (sequential) factorization added in. A threaded 
+    // factorization does not use the stack, and its update matrices, whose
+    // peak depends upon the schedule of the tasks, are counted as zero.
+    void PeakMemoryInfo
+    ( double& numLocalEntries, double& minLocalEntries, double& maxLocalEntries,
+      double& numGlobalEntries ) const;
+
     void FactorizationWork
     ( double& numLocalFlops, double& minLocalFlops, double& maxLocalFlops,
       double& numGlobalFlops, bool selInv=false ) const;
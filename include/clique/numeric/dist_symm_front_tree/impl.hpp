@@ -26,15 +26,24 @@ DistSymmFrontTree<F>::Initialize
   const DistMap& reordering,
   const DistSeparatorTree& sepTree, 
   const DistSymmInfo& info,
-  bool conjugate )
+  bool conjugate, bool keepRefactorMeta )
 {
     DEBUG_ONLY(
         CallStackEntry cse("DistSymmFrontTree::Initialize");
         if( A.LocalHeight() != reordering.NumLocalSources() )
             LogicError("Local mapping was not the right size");
     )
+    // Fronts which view a mapped factorization cannot be refilled in place
+    if( frontStore.Mapped() )
+    {
+        SwapClear( localFronts );
+        SwapClear( distFronts );
+    }
+    frontStore.Close();
     frontType = SYMM_2D;
     isHermitian = conjugate;
+    FrontFillMeta& meta = fillMeta;
+    meta.Empty();
     
     mpi::Comm comm = A.Comm();
     const DistGraph& graph = A.LockedDistGraph();
@@ -179,6 +188,8 @@ DistSymmFrontTree<F>::Initialize
     }
     std::vector<F> sendEntries( numSendEntries );
     std::vector<int> sendTargets( numSendEntries );
+    if( keepRefactorMeta )
+        meta.sendEntryInds.resize( numSendEntries );
     for( int q=0; q<commSize; ++q )
     {
         int index = sendEntriesOffs[q];
@@ -202,6 +213,8 @@ DistSymmFrontTree<F>::Initialize
                 )
                 sendEntries[index] = (conjugate ? El::Conj(value) : value);
                 sendTargets[index] = mappedTarget;
+                if( keepRefactorMeta )
+                    meta.sendEntryInds[index] = localEntryOff+t;
                 ++index;
             }
         }
@@ -238,9 +251,17 @@ DistSymmFrontTree<F>::Initialize
     ( &sendTargets[0], &sendEntriesSizes[0], &sendEntriesOffs[0],
       &recvTargets[0], &recvEntriesSizes[0], &recvEntriesOffs[0], comm );
 
-    // Unpack the received entries
+    // Unpack the received entries (and remember where each one went)
     offs = recvRowOffs;
     std::vector<int> entryOffs = recvEntriesOffs;
+    if( keepRefactorMeta )
+    {
+        meta.recvFronts.resize( numRecvEntries, -1 );
+        meta.recvLocalRows.resize( numRecvEntries );
+        meta.recvLocalCols.resize( numRecvEntries );
+    }
+    meta.frontHeights.resize( numLocal+numDist );
+    meta.frontWidths.resize( numLocal+numDist );
     localFronts.resize( numLocal );
     for( int s=0; s<numLocal; ++s )
     {
@@ -253,6 +274,8 @@ DistSymmFrontTree<F>::Initialize
         const int off = node.off;
         const int lowerSize = node.lowerStruct.size();
         Zeros( front.frontL, size+lowerSize, size );
+        meta.frontHeights[s] = size+lowerSize;
+        meta.frontWidths[s] = size;
         DEBUG_ONLY(
             if( size != (int)sepOrLeaf.inds.size() )
                 LogicError("Mismatch between separator and node size");
@@ -272,11 +295,12 @@ DistSymmFrontTree<F>::Initialize
                 const int target = recvTargets[entryOff];
                 ++entryOff;
 
+                int row;
                 if( target < off+t )
                     continue;
                 else if( target < off+size )
                 {
-                    front.frontL.Set( target-off, t, value );
+                    row = target-off;
                 }
                 else
                 {
@@ -285,12 +309,18 @@ DistSymmFrontTree<F>::Initialize
                         if( origOff >= (int)node.origLowerRelInds.size() )
                             LogicError("origLowerRelInds too small");
                     )
-                    const int row = node.origLowerRelInds[origOff];
+                    row = node.origLowerRelInds[origOff];
                     DEBUG_ONLY(
                         if( row < t )
                             LogicError("Tried to touch upper triangle");
                     )
-                    front.frontL.Set( row, t, value );
+                }
+                front.frontL.Set( row, t, value );
+                if( keepRefactorMeta )
+                {
+                    meta.recvFronts[entryOff-1] = s;
+                    meta.recvLocalRows[entryOff-1] = row;
+                    meta.recvLocalCols[entryOff-1] = t;
                 }
             }
         }
@@ -315,6 +345,8 @@ DistSymmFrontTree<F>::Initialize
         const int lowerSize = node.lowerStruct.size();
         front.front2dL.SetGrid( grid );
         Zeros( front.front2dL, size+lowerSize, size );
+        meta.frontHeights[numLocal+s] = size+lowerSize;
+        meta.frontWidths[numLocal+s] = size;
         DEBUG_ONLY(
             if( size != (int)sep.inds.size() )
                 LogicError("Mismatch in separator and node sizes");
@@ -335,16 +367,12 @@ DistSymmFrontTree<F>::Initialize
                 const int target = recvTargets[entryOff];
                 ++entryOff;
 
+                int row;
                 if( target < off+t )
                     continue;
                 else if( target < off+size )
                 {
-                    if( (target-off) % colStride == colShift )
-                    {
-                        const int row = target-off;
-                        const int localRow = (row-colShift) / colStride;
-                        front.front2dL.SetLocal( localRow, localCol, value );
-                    }
+                    row = target-off;
                 }
                 else 
                 {
@@ -353,15 +381,21 @@ DistSymmFrontTree<F>::Initialize
                         if( origOff >= (int)node.origLowerRelInds.size() )
                             LogicError("origLowerRelInds too small");
                     )
-                    const int row = node.origLowerRelInds[origOff];
+                    row = node.origLowerRelInds[origOff];
                     DEBUG_ONLY(
                         if( row < t )
                             LogicError("Tried to touch upper triangle");
                     )
-                    if( row % colStride == colShift )
+                }
+                if( row % colStride == colShift )
+                {
+                    const int localRow = (row-colShift) / colStride;
+                    front.front2dL.SetLocal( localRow, localCol, value );
+                    if( keepRefactorMeta )
                     {
-                        const int localRow = (row-colShift) / colStride;
-                        front.front2dL.SetLocal( localRow, localCol, value );
+                        meta.recvFronts[entryOff-1] = numLocal+s;
+                        meta.recvLocalRows[entryOff-1] = localRow;
+                        meta.recvLocalCols[entryOff-1] = localCol;
                     }
                 }
             }
@@ -381,8 +415,185 @@ DistSymmFrontTree<F>::Initialize
         bottomDist.LockedAttach
         ( topLocal.Height(), topLocal.Width(), *node.grid, 0, 0, topLocal );
     }
+    if( !keepRefactorMeta )
+    {
+        SwapClear( meta.frontHeights );
+        SwapClear( meta.frontWidths );
+        return;
+    }
+
+    // Tell the owners which of the entries were kept so that only those 
+    // values are sent by Refactor
+    std::vector<int> recvKeep( numRecvEntries ), sendKeep( numSendEntries );
+    for( int k=0; k<numRecvEntries; ++k )
+        recvKeep[k] = ( meta.recvFronts[k] >= 0 );
+    mpi::AllToAll
+    ( &recvKeep[0], &recvEntriesSizes[0], &recvEntriesOffs[0],
+      &sendKeep[0], &sendEntriesSizes[0], &sendEntriesOffs[0], comm );
+    int numKept=0;
+    std::vector<int> sendKeptSizes( commSize, 0 );
+    for( int q=0; q<commSize; ++q )
+    {
+        const int size = sendEntriesSizes[q];
+        const int off = sendEntriesOffs[q];
+        for( int k=off; k<off+size; ++k )
+        {
+            if( sendKeep[k] )
+            {
+                meta.sendEntryInds[numKept++] = meta.sendEntryInds[k];
+                ++sendKeptSizes[q];
+            }
+        }
+    }
+    meta.sendEntryInds.resize( numKept );
+    numKept=0;
+    std::vector<int> recvKeptSizes( commSize, 0 );
+    for( int q=0; q<commSize; ++q )
+    {
+        const int size = recvEntriesSizes[q];
+        const int off = recvEntriesOffs[q];
+        for( int k=off; k<off+size; ++k )
+        {
+            if( recvKeep[k] )
+            {
+                meta.recvFronts[numKept] = meta.recvFronts[k];
+                meta.recvLocalRows[numKept] = meta.recvLocalRows[k];
+                meta.recvLocalCols[numKept] = meta.recvLocalCols[k];
+                ++numKept;
+                ++recvKeptSizes[q];
+            }
+        }
+    }
+    meta.recvFronts.resize( numKept );
+    meta.recvLocalRows.resize( numKept );
+    meta.recvLocalCols.resize( numKept );
+    // The plan is set up over the (congruent) communicator of the analysis,
+    // which the fronts already depend upon, rather than that of A, which may 
+    // be freed before the next call to Refactor
+    DEBUG_ONLY(
+        if( !mpi::Congruent( comm, info.distNodes.back().comm ) )
+            LogicError("A's communicator was not congruent with the analysis");
+    )
+    meta.plan.Setup<F>
+    ( sendKeptSizes, recvKeptSizes, info.distNodes.back().comm );
+    meta.conjugate = conjugate;
+    meta.numLocalEntries = A.NumLocalEntries();
+    meta.ready = true;
+}
+
+template<typename F>
+inline void
+DistSymmFrontTree<F>::Refactor( const DistSparseMatrix<F>& A )
+{
+    DEBUG_ONLY(CallStackEntry cse("DistSymmFrontTree::Refactor"))
+    if( !fillMeta.ready )
+        LogicError
+        ("Refactor requires the fill pattern, which was not kept by "
+         "Initialize");
+    // The cached entry indices would silently read the wrong values (or out 
+    // of bounds) if the pattern had changed
+    if( A.NumLocalEntries() != fillMeta.numLocalEntries )
+        LogicError("The sparsity pattern of A has changed");
+    const FrontFillMeta& meta = fillMeta;
+    frontType = SYMM_2D;
+
+    // Reset the fronts to zero (after discarding any which were written out).
+    // Each distributed front keeps the grid of the analysis it was built for, 
+    // so the grids are taken from the fronts rather than being cached.
+    frontStore.Reset();
+    const int numLocal = localFronts.size();
+    const int numDist = distFronts.size()-1;
+    for( int s=0; s<numLocal; ++s )
+    {
+        SymmFront<F>& front = localFronts[s];
+        front.diag.Empty();
+        front.subdiag.Empty();
+        front.piv.Empty();
+        front.work.Empty();
+        Zeros( front.frontL, meta.frontHeights[s], meta.frontWidths[s] );
+    }
+    for( int s=0; s<=numDist; ++s )
+    {
+        DistSymmFront<F>& front = distFronts[s];
+        front.front1dL.Empty();
+        front.diag1d.Empty();
+        front.subdiag1d.Empty();
+        front.piv.Empty();
+        front.work1d.Empty();
+        front.work2d.Empty();
+        if( s == 0 )
+        {
+            const Matrix<F>& topLocal = localFronts.back().frontL;
+            const Grid& grid = front.front2dL.Grid();
+            front.front2dL.LockedAttach
+            ( topLocal.Height(), topLocal.Width(), grid, 0, 0, topLocal );
+        }
+        else
+        {
+            front.front2dL.Empty();
+            Zeros
+            ( front.front2dL, meta.frontHeights[numLocal+s-1], 
+              meta.frontWidths[numLocal+s-1] );
+        }
+    }
+
+    // Send the new values
+    CommPlan& plan = fillMeta.plan;
+    F* sendVals = plan.SendBuffer<F>();
+    const int numSendEntries = meta.sendEntryInds.size();
+    for( int k=0; k<numSendEntries; ++k )
+    {
+        const F value = A.Value( meta.sendEntryInds[k] );
+        sendVals[k] = ( meta.conjugate ? El::Conj(value) : value );
+    }
+    plan.Exchange();
+
+    // Scatter the received values into the fronts
+    const F* recvVals = plan.LockedRecvBuffer<F>();
+    const int numRecvEntries = meta.recvFronts.size();
+    for( int k=0; k<numRecvEntries; ++k )
+    {
+        const int f = meta.recvFronts[k];
+        if( f < numLocal )
+            localFronts[f].frontL.Set
+            ( meta.recvLocalRows[k], meta.recvLocalCols[k], recvVals[k] );
+        else
+            distFronts[f-numLocal+1].front2dL.SetLocal
+            ( meta.recvLocalRows[k], meta.recvLocalCols[k], recvVals[k] );
+    }
 }
 
+template<typename F>
+inline void
+DistSymmFrontTree<F>::SetOutOfCore( const std::string& basename )
+{
+    DEBUG_ONLY(CallStackEntry cse("DistSymmFrontTree::SetOutOfCore"))
+    if( !Unfactored(frontType) )
+        LogicError("Out-of-core mode must be enabled before factoring");
+    const bool frontsAre1d = FrontsAre1d( frontType );
+    const Grid& grid = ( frontsAre1d ? distFronts.back().front1dL.Grid() 
+                                     : distFronts.back().front2dL.Grid() );
+    std::ostringstream os;
+    os << basename << "." << mpi::Rank( grid.Comm() );
+    const int numFronts = localFronts.size() + distFronts.size() - 1;
+    frontStore.Open( os.str(), numFronts );
+}
+
+template<typename F>
+inline bool
+DistSymmFrontTree<F>::OutOfCore() const
+{ return frontStore.Active(); }
+
+template<typename F>
+inline void
+DistSymmFrontTree<F>::FetchLocalFront( int s ) const
+{ frontStore.Fetch( s ); }
+
+template<typename F>
+inline void
+DistSymmFrontTree<F>::FetchDistFront( int s ) const
+{ frontStore.Fetch( localFronts.size()+s-1 ); }
+
 template<typename F>
 inline
 DistSymmFrontTree<F>::DistSymmFrontTree
@@ -390,10 +601,10 @@ DistSymmFrontTree<F>::DistSymmFrontTree
   const DistMap& reordering,
   const DistSeparatorTree& sepTree, 
   const DistSymmInfo& info,
-  bool conjugate )
+  bool conjugate, bool keepRefactorMeta )
 {
     DEBUG_ONLY(CallStackEntry cse("DistSymmFrontTree::DistSymmFrontTree"))
-    Initialize( A, reordering, sepTree, info, conjugate );
+    Initialize( A, reordering, sepTree, info, conjugate, keepRefactorMeta );
 }
 
 template<typename F>
@@ -420,6 +631,8 @@ DistSymmFrontTree<F>::MemoryInfo
         numLocalEntries += front.piv.MemorySize();
         numLocalEntries += front.work.MemorySize();
     }
+    numLocalEntries += solveArena.Capacity();
+    numLocalEntries += updateArena.Capacity();
     for( int s=1; s<numDistFronts; ++s )
     {
         const DistSymmFront<F>& front = distFronts[s];
@@ -437,6 +650,30 @@ DistSymmFrontTree<F>::MemoryInfo
     numGlobalEntries = mpi::AllReduce( numLocalEntries, mpi::SUM, comm );
 }
 
+template<typename F>
+inline void
+DistSymmFrontTree<F>::PeakMemoryInfo
+( double& numLocalEntries, double& minLocalEntries, double& maxLocalEntries, 
+  double& numGlobalEntries ) const
+{
+    DEBUG_ONLY(CallStackEntry cse("DistSymmFrontTree::PeakMemoryInfo"))
+    MemoryInfo
+    ( numLocalEntries, minLocalEntries, maxLocalEntries, numGlobalEntries );
+    // The update stack is only fully resident during the factorization, so 
+    // its peak replaces whatever portion of it is currently allocated (the
+    // peak is zero after a threaded factorization, which clears the stack)
+    numLocalEntries -= updateArena.Capacity();
+    numLocalEntries += updateArena.PeakEntries();
+
+    const bool frontsAre1d = FrontsAre1d( frontType );
+    const Grid& grid = ( frontsAre1d ? distFronts.back().front1dL.Grid() 
+                                     : distFronts.back().front2dL.Grid() );
+    mpi::Comm comm = grid.Comm();
+    minLocalEntries = mpi::AllReduce( numLocalEntries, mpi::MIN, comm );
+    maxLocalEntries = mpi::AllReduce( numLocalEntries, mpi::MAX, comm );
+    numGlobalEntries = mpi::AllReduce( numLocalEntries, mpi::SUM, comm );
+}
+
 template<typename F>
 inline void
 DistSymmFrontTree<F>::TopLeftMemoryInfo
@@ -0,0 +1,119 @@
+/*
+   Copyright (c) 2009-2014, Jack Poulson, Lexing Ying,
+   The University of Texas at Austin, Stanford University, and the
+   Georgia Insitute of Technology.
+   All rights reserved.
+ 
+   This file is part of Clique and is under the BSD 2-Clause License, 
+   which can be found in the LICENSE file in the root directory, or at 
+   http://opensource.org/licenses/BSD-2-Clause
+*/
+#pragma once
+#ifndef CLIQ_NUMERIC_FRONTSTORE_DECL_HPP
+#define CLIQ_NUMERIC_FRONTSTORE_DECL_HPP
+
+namespace cliq {
+
+// Out-of-core storage for the factored fronts of a single process. Offloading
+// a front appends its local entries to a scratch file and replaces it with an
+// (unbacked) view of the same dimensions, so that the sizes and grids of the
+// fronts may still be queried. Fetching a front reads it back into one of two
+// resident buffers and attaches the front to it; the next front in the
+// direction of traversal is then read into the other buffer asynchronously,
+// so that at most two offloaded fronts are resident at any time.
+//
+// Each front is identified by an index which is chosen by the caller, and the
+// fronts should be fetched in increasing or decreasing order of their indices
+// so that the prefetches are useful.
+//
+// Alternatively, the store can hold a read-only mapping of a file (e.g., one
+// written by SaveFactorization) which the fronts are views into.
+
+// Map the given file read-only into memory. If the file could not be mapped,
+// then a null pointer is returned.
+const byte* MapFile( const std::string& filename, std::size_t& mapSize );
+void UnmapFile( const byte* map, std::size_t mapSize );
+
+template<typename F>
+class FrontStore
+{
+public:
+    FrontStore();
+    ~FrontStore();
+
+    // Start (or restart) writing fronts with indices in [0,numFronts) to the
+    // given file, which is truncated now and removed by Close (which also
+    // releases any mapping)
+    void Open( const std::string& filename, int numFronts );
+    void Close();
+    bool Active() const;
+
+    // Forget all of the offloaded fronts (emptying their views) and truncate
+    // the file so that the fronts may be refilled and offloaded again
+    void Reset();
+
+    // These routines may be called concurrently by different threads
+    void Offload( int index, Matrix<F>& front );
+    void Offload( int index, DistMatrix<F>& front );
+    void Offload( int index, DistMatrix<F,VC,STAR>& front );
+    bool Offloaded( int index ) const;
+
+    // Make the given front resident (which has no effect if it was never
+    // offloaded) and start prefetching the next offloaded front
+    void Fetch( int index );
+
+    // Detach the resident fronts (after waiting for any prefetch) in order to
+    // free the buffers
+    void Release();
+
+    // The number of bytes which have been written to the file
+    std::size_t FileSize() const;
+
+    // Close the store and take ownership of a mapping returned by MapFile,
+    // which is released by Close (any fronts which view the mapping must be
+    // emptied first)
+    void AdoptMap( const byte* map, std::size_t mapSize );
+    bool Mapped() const;
+    std::size_t MappedSize() const;
+
+private:
+    enum FrontKind { NOT_OFFLOADED, LOCAL_FRONT, DIST_FRONT_2D, DIST_FRONT_1D };
+
+    struct FrontRecord
+    {
+        FrontKind kind;
+        void* front;
+        const Grid* grid;
+        int height, width, colAlign, rowAlign, localHeight, localWidth;
+        std::streamoff offset;
+
+        FrontRecord() : kind(NOT_OFFLOADED), front(0), grid(0) { }
+    };
+
+    std::string filename_;
+    std::fstream file_;
+    std::streamoff end_;
+    std::mutex writeMutex_;
+
+    std::vector<FrontRecord> records_;
+    int current_, next_, lastFetched_;
+    bool ascending_;
+    std::vector<F> currentBuffer_, nextBuffer_;
+    std::future<void> prefetch_;
+
+    const byte* map_;
+    std::size_t mapSize_;
+
+    FrontStore( const FrontStore& store );
+    const FrontStore& operator=( const FrontStore& store );
+
+    void Write( FrontRecord& record, const F* buffer, int ldim );
+    void Read( const FrontRecord& record, F* buffer );
+    void Attach( const FrontRecord& record, const F* buffer );
+    void Detach( const FrontRecord& record );
+    void WaitForPrefetch();
+};
+
+} // namespace cliq
+
+#endif // ifndef CLIQ_NUMERIC_FRONTSTORE_DECL_HPP
@@ -0,0 +1,398 @@
+/*
+   Copyright (c) 2009-2014, Jack Poulson, Lexing Ying,
+   The University of Texas at Austin, Stanford University, and the
+   Georgia Insitute of Technology.
+   All rights reserved.
+ 
+   This file is part of Clique and is under the BSD 2-Clause License, 
+   which can be found in the LICENSE file in the root directory, or at 
+   http://opensource.org/licenses/BSD-2-Clause
+*/
+#pragma once
+#ifndef CLIQ_NUMERIC_FRONTSTORE_IMPL_HPP
+#define CLIQ_NUMERIC_FRONTSTORE_IMPL_HPP
+
+namespace cliq {
+
+// Fronts with fewer bytes than this are read by the thread which fetches them
+// rather than being prefetched by a separate thread
+const std::size_t minFrontPrefetchBytes = 1<<18;
+
+inline const byte*
+MapFile( const std::string& filename, std::size_t& mapSize )
+{
+    DEBUG_ONLY(CallStackEntry cse("MapFile"))
+    const int fd = ::open( filename.c_str(), O_RDONLY );
+    if( fd < 0 )
+        return 0;
+    struct stat fileStat;
+    if( fstat( fd, &fileStat ) != 0 || fileStat.st_size == 0 )
+    {
+        ::close( fd );
+        return 0;
+    }
+    void* map = mmap( 0, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+    // The mapping remains valid after the descriptor is closed
+    ::close( fd );
+    if( map == MAP_FAILED )
+        return 0;
+    mapSize = fileStat.st_size;
+    return static_cast<const byte*>(map);
+}
+
+inline void
+UnmapFile( const byte* map, std::size_t mapSize )
+{ munmap( const_cast<byte*>(map), mapSize ); }
+
+template<typename F>
+inline
+FrontStore<F>::FrontStore()
+: end_(0), current_(-1), next_(-1), lastFetched_(-1), ascending_(true),
+  map_(0), mapSize_(0)
+{ }
+
+template<typename F>
+inline
+FrontStore<F>::~FrontStore()
+{
+    // The fronts may have already been destroyed, so only the file is closed
+    if( prefetch_.valid() )
+        prefetch_.wait();
+    if( file_.is_open() )
+    {
+        file_.close();
+        std::remove( filename_.c_str() );
+    }
+    if( map_ != 0 )
+        UnmapFile( map_, mapSize_ );
+}
+
+template<typename F>
+inline void
+FrontStore<F>::Open( const std::string& filename, int numFronts )
+{
+    DEBUG_ONLY(CallStackEntry cse("FrontStore::Open"))
+    Close();
+    filename_ = filename;
+    file_.open
+    ( filename.c_str(),
+      std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc );
+    if( !file_.is_open() )
+        RuntimeError("Could not open ",filename);
+    end_ = 0;
+    records_.resize( numFronts );
+    current_ = next_ = lastFetched_ = -1;
+    ascending_ = true;
+}
+
+template<typename F>
+inline void
+FrontStore<F>::Close()
+{
+    DEBUG_ONLY(CallStackEntry cse("FrontStore::Close"))
+    if( map_ != 0 )
+    {
+        UnmapFile( map_, mapSize_ );
+        map_ = 0;
+        mapSize_ = 0;
+    }
+    if( !Active() )
+        return;
+    Reset();
+    file_.close();
+    std::remove( filename_.c_str() );
+    SwapClear( records_ );
+}
+
+template<typename F>
+inline bool
+FrontStore<F>::Active() const
+{ return file_.is_open(); }
+
+template<typename F>
+inline void
+FrontStore<F>::Reset()
+{
+    DEBUG_ONLY(CallStackEntry cse("FrontStore::Reset"))
+    if( !Active() )
+        return;
+    WaitForPrefetch();
+    const int numFronts = records_.size();
+    for( int index=0; index<numFronts; ++index )
+    {
+        FrontRecord& record = records_[index];
+        if( record.kind == LOCAL_FRONT )
+            static_cast<Matrix<F>*>(record.front)->Empty();
+        else if( record.kind == DIST_FRONT_2D )
+            static_cast<DistMatrix<F>*>(record.front)->Empty();
+        else if( record.kind == DIST_FRONT_1D )
+            static_cast<DistMatrix<F,VC,STAR>*>(record.front)->Empty();
+        record = FrontRecord();
+    }
+    current_ = next_ = lastFetched_ = -1;
+    ascending_ = true;
+    SwapClear( currentBuffer_ );
+    SwapClear( nextBuffer_ );
+
+    file_.close();
+    file_.open
+    ( filename_.c_str(),
+      std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc );
+    if( !file_.is_open() )
+        RuntimeError("Could not reopen ",filename_);
+    end_ = 0;
+}
+
+template<typename F>
+inline void
+FrontStore<F>::Offload( int index, Matrix<F>& front )
+{
+    DEBUG_ONLY(
+        CallStackEntry cse("FrontStore::Offload");
+        if( index < 0 || index >= int(records_.size()) )
+            LogicError("Front index ",index," is out of bounds");
+    )
+    FrontRecord& record = records_[index];
+    record.front = &front;
+    record.grid = 0;
+    record.height = record.localHeight = front.Height();
+    record.width = record.localWidth = front.Width();
+    record.colAlign = record.rowAlign = 0;
+    Write( record, front.LockedBuffer(), front.LDim() );
+    record.kind = LOCAL_FRONT;
+    front.Empty();
+    Detach( record );
+}
+
+template<typename F>
+inline void
+FrontStore<F>::Offload( int index, DistMatrix<F>& front )
+{
+    DEBUG_ONLY(
+        CallStackEntry cse("FrontStore::Offload");
+        if( index < 0 || index >= int(records_.size()) )
+            LogicError("Front index ",index," is out of bounds");
+    )
+    FrontRecord& record = records_[index];
+    record.front = &front;
+    record.grid = &front.Grid();
+    record.height = front.Height();
+    record.width = front.Width();
+    record.colAlign = front.ColAlign();
+    record.rowAlign = front.RowAlign();
+    record.localHeight = front.LocalHeight();
+    record.localWidth = front.LocalWidth();
+    Write( record, front.LockedBuffer(), front.LDim() );
+    record.kind = DIST_FRONT_2D;
+    front.Empty();
+    Detach( record );
+}
+
+template<typename F>
+inline void
+FrontStore<F>::Offload( int index, DistMatrix<F,VC,STAR>& front )
+{
+    DEBUG_ONLY(
+        CallStackEntry cse("FrontStore::Offload");
+        if( index < 0 || index >= int(records_.size()) )
+            LogicError("Front index ",index," is out of bounds");
+    )
+    FrontRecord& record = records_[index];
+    record.front = &front;
+    record.grid = &front.Grid();
+    record.height = front.Height();
+    record.width = front.Width();
+    record.colAlign = front.ColAlign();
+    record.rowAlign = front.RowAlign();
+    record.localHeight = front.LocalHeight();
+    record.localWidth = front.LocalWidth();
+    Write( record, front.LockedBuffer(), front.LDim() );
+    record.kind = DIST_FRONT_1D;
+    front.Empty();
+    Detach( record );
+}
+
+template<typename F>
+inline bool
+FrontStore<F>::Offloaded( int index ) const
+{
+    return Active() && index >= 0 && index < int(records_.size()) &&
+           records_[index].kind != NOT_OFFLOADED;
+}
+
+template<typename F>
+inline void
+FrontStore<F>::Fetch( int index )
+{
+    DEBUG_ONLY(
+        CallStackEntry cse("FrontStore::Fetch");
+        if( Active() && (index < 0 || index >= int(records_.size())) )
+            LogicError("Front index ",index," is out of bounds");
+    )
+    if( !Active() || records_[index].kind == NOT_OFFLOADED )
+        return;
+
+    // Fetching the same front twice in a row reverses the direction of
+    // traversal (e.g., between the forward and backward solves)
+    if( index == lastFetched_ )
+        ascending_ = !ascending_;
+    else
+        ascending_ = ( index > lastFetched_ );
+    lastFetched_ = index;
+
+    if( index != current_ )
+    {
+        WaitForPrefetch();
+        if( current_ != -1 )
+            Detach( records_[current_] );
+        const FrontRecord& record = records_[index];
+        if( next_ == index )
+            std::swap( currentBuffer_, nextBuffer_ );
+        else
+        {
+            currentBuffer_.resize( record.localHeight*record.localWidth );
+            Read( record, currentBuffer_.data() );
+        }
+        current_ = index;
+        next_ = -1;
+        Attach( record, currentBuffer_.data() );
+    }
+
+    // Find the next offloaded front in the direction of traversal
+    const int numFronts = records_.size();
+    int nextIndex = index;
+    do
+    {
+        nextIndex += ( ascending_ ? 1 : -1 );
+    } while( nextIndex >= 0 && nextIndex < numFronts &&
+             records_[nextIndex].kind == NOT_OFFLOADED );
+    if( nextIndex < 0 || nextIndex >= numFronts || nextIndex == next_ )
+        return;
+    const FrontRecord record = records_[nextIndex];
+    const std::size_t numEntries = record.localHeight*record.localWidth;
+    if( numEntries*sizeof(F) < minFrontPrefetchBytes )
+        return;
+
+    // Read the next front into the spare buffer in the background
+    WaitForPrefetch();
+    nextBuffer_.resize( numEntries );
+    next_ = nextIndex;
+    F* buffer = nextBuffer_.data();
+    prefetch_ =
+        std::async
+        ( std::launch::async, [this,record,buffer]() { Read(record,buffer); } );
+}
+
+template<typename F>
+inline void
+FrontStore<F>::Release()
+{
+    DEBUG_ONLY(CallStackEntry cse("FrontStore::Release"))
+    if( !Active() )
+        return;
+    WaitForPrefetch();
+    if( current_ != -1 )
+        Detach( records_[current_] );
+    current_ = next_ = lastFetched_ = -1;
+    ascending_ = true;
+    SwapClear( currentBuffer_ );
+    SwapClear( nextBuffer_ );
+}
+
+template<typename F>
+inline std::size_t
+FrontStore<F>::FileSize() const
+{ return end_; }
+
+template<typename F>
+inline void
+FrontStore<F>::AdoptMap( const byte* map, std::size_t mapSize )
+{
+    DEBUG_ONLY(CallStackEntry cse("FrontStore::AdoptMap"))
+    Close();
+    map_ = map;
+    mapSize_ = mapSize;
+}
+
+template<typename F>
+inline bool
+FrontStore<F>::Mapped() const
+{ return map_ != 0; }
+
+template<typename F>
+inline std::size_t
+FrontStore<F>::MappedSize() const
+{ return mapSize_; }
+
+template<typename F>
+inline void
+FrontStore<F>::Write( FrontRecord& record, const F* buffer, int ldim )
+{
+    DEBUG_ONLY(CallStackEntry cse("FrontStore::Write"))
+    const std::size_t colBytes = record.localHeight*sizeof(F);
+    std::lock_guard<std::mutex> lock( writeMutex_ );
+    record.offset = end_;
+    file_.seekp( end_ );
+    for( int j=0; j<record.localWidth; ++j )
+        file_.write
+        ( reinterpret_cast<const char*>(&buffer[j*ldim]), colBytes );
+    if( !file_ )
+        RuntimeError("Could not write front to ",filename_);
+    end_ += record.localWidth*colBytes;
+}
+
+template<typename F>
+inline void
+FrontStore<F>::Read( const FrontRecord& record, F* buffer )
+{
+    const std::size_t numEntries = record.localHeight*record.localWidth;
+    file_.seekg( record.offset );
+    file_.read( reinterpret_cast<char*>(buffer), numEntries*sizeof(F) );
+    if( !file_ )
+        RuntimeError("Could not read front from ",filename_);
+}
+
+template<typename F>
+inline void
+FrontStore<F>::Attach( const FrontRecord& record, const F* buffer )
+{
+    if( record.kind == LOCAL_FRONT )
+        static_cast<Matrix<F>*>(record.front)->LockedAttach
+        ( record.height, record.width, buffer,
+          std::max(record.localHeight,1) );
+    else if( record.kind == DIST_FRONT_2D )
+        static_cast<DistMatrix<F>*>(record.front)->LockedAttach
+        ( record.height, record.width, *record.grid,
+          record.colAlign, record.rowAlign, buffer,
+          std::max(record.localHeight,1) );
+    else if( record.kind == DIST_FRONT_1D )
+        static_cast<DistMatrix<F,VC,STAR>*>(record.front)->LockedAttach
+        ( record.height, record.width, *record.grid,
+          record.colAlign, record.rowAlign, buffer,
+          std::max(record.localHeight,1) );
+}
+
+// Offloaded fronts are attached to a null buffer so that their dimensions and
+// grids remain available
+template<typename F>
+inline void
+FrontStore<F>::Detach( const FrontRecord& record )
+{ Attach( record, 0 ); }
+
+template<typename F>
+inline void
+FrontStore<F>::WaitForPrefetch()
+{
+    if( !prefetch_.valid() )
+        return;
+    try { prefetch_.get(); }
+    catch( ... )
+    {
+        next_ = -1;
+        throw;
+    }
+}
+
+} // namespace cliq
+
+#endif // ifndef CLIQ_NUMERIC_FRONTSTORE_IMPL_HPP
@@ -20,10 +20,17 @@ namespace cliq {
 template<typename F>
 void InitializeDistLeaf( const DistSymmInfo& info, DistSymmFrontTree<F>& L );
 
+// If 'threadedLocal' is true, then the local subtree is factored using OpenMP
+// tasks (if Clique was configured with OpenMP support), and, if 
+// 'pipelinedDist' is true, the exchange of each distributed child update is 
+// overlapped with the factorization of the leading block of its parent front.
+// Unless 'keepCommPlans' is false, the buffers for the exchanges of the child
+// updates are kept within 'info' for later factorizations (see DistLDL).
 template<typename F>
 void LDL
 ( DistSymmInfo& info, DistSymmFrontTree<F>& L, 
-  SymmFrontType newFrontType=LDL_2D );
+  SymmFrontType newFrontType=LDL_2D, bool threadedLocal=false,
+  bool pipelinedDist=false, bool keepCommPlans=true );
 
 } // namespace cliq
 
@@ -56,7 +63,9 @@ inline void InitializeDistLeaf
 
 template<typename F>
 inline void 
-LDL( DistSymmInfo& info, DistSymmFrontTree<F>& L, SymmFrontType newFrontType )
+LDL
+( DistSymmInfo& info, DistSymmFrontTree<F>& L, SymmFrontType newFrontType,
+  bool threadedLocal, bool pipelinedDist, bool keepCommPlans )
 {
     DEBUG_ONLY(CallStackEntry cse("LDL"))
     if( !Unfactored(L.frontType) )
@@ -67,11 +76,28 @@ LDL( DistSymmInfo& info, DistSymmFrontTree<F>& L, SymmFrontType newFrontType )
 
     // Perform the initial factorization
     L.frontType = InitialFactorType(newFrontType);
-    LocalLDL( info, L );
-    DistLDL( info, L );
+    LocalLDL( info, L, threadedLocal );
+    DistLDL( info, L, pipelinedDist, keepCommPlans );
+    L.updateArena.Free();
 
     // Convert the fronts from the initial factorization to the requested form
     ChangeFrontType( L, newFrontType );
+
+    // Write out the distributed fronts (other than the leaf) if requested
+    if( L.frontStore.Active() )
+    {
+        const bool frontsAre1d = FrontsAre1d( L.frontType );
+        const int numLocal = L.localFronts.size();
+        const int numDist = L.distFronts.size();
+        for( int s=1; s<numDist; ++s )
+        {
+            DistSymmFront<F>& front = L.distFronts[s];
+            if( frontsAre1d )
+                L.frontStore.Offload( numLocal+s-1, front.front1dL );
+            else
+                L.frontStore.Offload( numLocal+s-1, front.front2dL );
+        }
+    }
 }
 
 } // namespace cliq
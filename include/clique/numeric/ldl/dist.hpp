@@ -14,17 +14,142 @@
 
 namespace cliq {
 
+// The child update matrices are exchanged using persistent communication 
+// plans which are built during the first factorization and reused afterwards.
+// If 'pipelined' is true, the exchange is performed in two phases: the portion
+// of the updates which lies within the leading block of each parent front is 
+// unpacked as each message arrives and then factored, while the remainder of
+// the updates (which only affect the Schur complement) is still in transit.
+// The plans are kept within 'info', and reused by later factorizations, until
+// the analysis is released. Since they hold persistent send and receive
+// buffers for the largest messages of the factorization, each can instead be
+// freed once its exchange completes by setting 'keepCommPlans' to false.
 template<typename F> 
 void 
-DistLDL( DistSymmInfo& info, DistSymmFrontTree<F>& L );
+DistLDL
+( DistSymmInfo& info, DistSymmFrontTree<F>& L, bool pipelined=false,
+  bool keepCommPlans=true );
 
 //----------------------------------------------------------------------------//
 // Implementation begins here                                                 //
 //----------------------------------------------------------------------------//
 
+template<typename F>
+inline void
+PackChildUpdate
+( const DistMatrix<F>& childUpdate, const std::vector<Int>& myChildRelInds,
+  int gridHeight, int gridWidth, Int jLocBeg, Int jLocEnd,
+  F* sendBuffer, std::vector<int>& packOffs )
+{
+    // If no buffer is provided, then the entries are only counted
+    const Grid& childGrid = childUpdate.Grid();
+    const Int childGridHeight = childGrid.Height();
+    const Int childGridWidth = childGrid.Width();
+    const Int updateColShift = childUpdate.ColShift();
+    const Int updateRowShift = childUpdate.RowShift();
+    const Int updateLocHeight = childUpdate.LocalHeight();
+    for( Int jChildLoc=jLocBeg; jChildLoc<jLocEnd; ++jChildLoc )
+    {
+        const Int jChild = updateRowShift + jChildLoc*childGridWidth;
+        const int destGridCol = myChildRelInds[jChild] % gridWidth;
+        Int localColShift;
+        if( updateColShift > jChild )
+            localColShift = 0;
+        else if( (jChild-updateColShift) % childGridHeight == 0 )
+            localColShift = (jChild-updateColShift)/childGridHeight;
+        else
+            localColShift = (jChild-updateColShift)/childGridHeight + 1;
+        for( Int iChildLoc=localColShift; 
+                 iChildLoc<updateLocHeight; ++iChildLoc )
+        {
+            const Int iChild = updateColShift + iChildLoc*childGridHeight;
+            if( iChild >= jChild )
+            {
+                const int destGridRow = myChildRelInds[iChild] % gridHeight;
+                const int destRank = destGridRow + destGridCol*gridHeight;
+                if( sendBuffer != 0 )
+                    sendBuffer[packOffs[destRank]] = 
+                        childUpdate.GetLocal(iChildLoc,jChildLoc);
+                ++packOffs[destRank];
+            }
+        }
+    }
+}
+
+template<typename F>
+inline void
+UnpackChildUpdate
+( DistSymmFront<F>& front, const F* recvVals, 
+  const std::vector<Int>& recvInds, Int indOff, Int numInds )
+{
+    // Value 'k' of the buffer corresponds to index pair 'indOff+k'
+    const Grid& grid = front.front2dL.Grid();
+    const Int gridHeight = grid.Height();
+    const Int leftLocWidth = front.front2dL.LocalWidth();
+    const Int topLocHeight = 
+        Length( front.front2dL.Width(), grid.Row(), gridHeight );
+    for( Int k=0; k<numInds; ++k )
+    {
+        const Int iFrontLoc = recvInds[2*(indOff+k)+0];
+        const Int jFrontLoc = recvInds[2*(indOff+k)+1];
+        const F value = recvVals[k];
+        DEBUG_ONLY(
+            const Int iFront = grid.Row() + iFrontLoc*gridHeight;
+            const Int jFront = grid.Col() + jFrontLoc*grid.Width();
+            if( iFront < jFront )
+                LogicError("Tried to update upper triangle");
+        )
+        if( jFrontLoc < leftLocWidth )
+            front.front2dL.UpdateLocal( iFrontLoc, jFrontLoc, value );
+        else
+            front.work2d.UpdateLocal
+            ( iFrontLoc-topLocHeight, jFrontLoc-leftLocWidth, value );
+    }
+}
+
+template<typename F>
+inline void
+FactorDistFront
+( DistSymmFront<F>& front, bool isHermitian, bool blocked, bool pivoted )
+{
+    const Grid& grid = front.front2dL.Grid();
+    if( blocked )
+    {
+        FrontBlockLDL
+        ( front.front2dL, front.work2d, isHermitian, pivoted );
+    }
+    else if( pivoted )
+    {
+        DistMatrix<F,MD,STAR> subdiag( grid );
+        front.piv.SetGrid( grid );
+        FrontLDLIntraPiv
+        ( front.front2dL, subdiag, front.piv, front.work2d, isHermitian );
+
+        // Store the main and subdiagonals in [VC,* ] distributions
+        auto diag = front.front2dL.GetDiagonal();
+        front.diag1d.SetGrid( grid );
+        front.subdiag1d.SetGrid( grid );
+        front.diag1d = diag;
+        front.subdiag1d = subdiag;
+        El::SetDiagonal( front.front2dL, F(1) );
+    }
+    else
+    {
+        FrontLDL( front.front2dL, front.work2d, isHermitian );
+
+        // Store the diagonal in a [VC,* ] distribution
+        auto diag = front.front2dL.GetDiagonal();
+        front.diag1d.SetGrid( grid );
+        front.diag1d = diag;
+        El::SetDiagonal( front.front2dL, F(1) );
+    }
+}
+
 template<typename F> 
 inline void 
-DistLDL( DistSymmInfo& info, DistSymmFrontTree<F>& L )
+DistLDL
+( DistSymmInfo& info, DistSymmFrontTree<F>& L, bool pipelined, 
+  bool keepCommPlans )
 {
     DEBUG_ONLY(CallStackEntry cse("DistLDL"))
     const SymmFrontType type = L.frontType;
@@ -80,160 +205,162 @@ DistLDL( DistSymmInfo& info, DistSymmFrontTree<F>& L )
         const unsigned gridHeight = grid.Height();
         const unsigned gridWidth = grid.Width();
 
-        // Grab the child's grid information
-        const Grid& childGrid = childFront.front2dL.Grid();
-        const unsigned childGridHeight = childGrid.Height();
-        const unsigned childGridWidth = childGrid.Width();
-
-        // Pack our child's update
+        // Grab our child's update and the indices we will receive
         const FactorCommMeta& commMeta = node.factorMeta;
         const DistMatrix<F>& childUpdate = childFront.work2d;
         const bool onLeft = childNode.onLeft;
-        std::vector<int> sendCounts(commSize), sendDispls(commSize);
-        Int sendBufferSize = 0;
-        for( Unsigned proc=0; proc<commSize; ++proc )
-        {
-            const Int sendSize = commMeta.numChildSendInds[proc];
-            sendCounts[proc] = sendSize;
-            sendDispls[proc] = sendBufferSize;
-            sendBufferSize += sendSize;
-        }
-        std::vector<F> sendBuffer( sendBufferSize );
-
         const std::vector<Int>& myChildRelInds = 
             ( onLeft ? node.leftRelInds : node.rightRelInds );
-        const Int updateColShift = childUpdate.ColShift();
-        const Int updateRowShift = childUpdate.RowShift();
-        const Int updateLocHeight = childUpdate.LocalHeight();
         const Int updateLocWidth = childUpdate.LocalWidth();
-        std::vector<int> packOffs = sendDispls;
-        for( Int jChildLoc=0; jChildLoc<updateLocWidth; ++jChildLoc )
-        {
-            const Int jChild = updateRowShift + jChildLoc*childGridWidth;
-            const int destGridCol = myChildRelInds[jChild] % gridWidth;
-            Int localColShift;
-            if( updateColShift > jChild )
-                localColShift = 0;
-            else if( (jChild-updateColShift) % childGridHeight == 0 )
-                localColShift = (jChild-updateColShift)/childGridHeight;
-            else
-                localColShift = (jChild-updateColShift)/childGridHeight + 1;
-            for( Int iChildLoc=localColShift; 
-                     iChildLoc<updateLocHeight; ++iChildLoc )
-            {
-                const Int iChild = updateColShift + iChildLoc*childGridHeight;
-                if( iChild >= jChild )
-                {
-                    const int destGridRow = myChildRelInds[iChild] % gridHeight;
-                    const int destRank = destGridRow + destGridCol*gridHeight;
-                    sendBuffer[packOffs[destRank]++] = 
-                        childUpdate.GetLocal(iChildLoc,jChildLoc);
-                }
-            }
-        }
-        DEBUG_ONLY(
-            for( unsigned proc=0; proc<commSize; ++proc )
-            {
-                if( packOffs[proc]-sendDispls[proc] != 
-                    commMeta.numChildSendInds[proc] )
-                    LogicError("Error in packing stage");
-            }
-        )
-        SwapClear( packOffs );
-        childFront.work2d.Empty();
-        if( s == 1 )
-            topLocFront.work.Empty();
-
-        // Set up the recv buffer for the AllToAll
         const bool computeFactRecvInds = ( commMeta.childRecvInds.size() == 0 );
         if( computeFactRecvInds )
             ComputeFactRecvInds( node, childNode );
-        std::vector<int> recvCounts(commSize), recvDispls(commSize);
-        Int recvBufferSize=0;
-        for( unsigned proc=0; proc<commSize; ++proc )
-        {
-            const Int recvSize = commMeta.childRecvInds[proc].size()/2;
-            recvCounts[proc] = recvSize;
-            recvDispls[proc] = recvBufferSize;
-            recvBufferSize += recvSize;
-        }
-        std::vector<F> recvBuffer( recvBufferSize );
-        DEBUG_ONLY(VerifySendsAndRecvs( sendCounts, recvCounts, comm ))
-
-        // AllToAll to send and receive the child updates
-        SparseAllToAll
-        ( sendBuffer, sendCounts, sendDispls,
-          recvBuffer, recvCounts, recvDispls, comm );
-        SwapClear( sendBuffer );
-        SwapClear( sendCounts );
-        SwapClear( sendDispls );
-
-        // Unpack the child udpates (with an Axpy)
+
         front.work2d.SetGrid( front.front2dL.Grid() );
         front.work2d.Align( node.size % gridHeight, node.size % gridWidth );
         Zeros( front.work2d, updateSize, updateSize );
-        const Int leftLocWidth = front.front2dL.LocalWidth();
-        const Int topLocHeight = Length( node.size, grid.Row(), gridHeight );
-        for( unsigned proc=0; proc<commSize; ++proc )
+        if( pipelined )
         {
-            const F* recvVals = &recvBuffer[recvDispls[proc]];
-            const std::vector<Int>& recvInds = commMeta.childRecvInds[proc];
-            const Int numRecvIndPairs = recvInds.size()/2;
-            for( Int k=0; k<numRecvIndPairs; ++k )
+            // Since the relative indices are increasing, and each process 
+            // packs (and receives) entries in column-major order, the entries
+            // which lie in the leading block of the front form a prefix of 
+            // each message. Each message is therefore split into a leading 
+            // and a trailing piece, which are exchanged by separate plans.
+            const Int updateRowShift = childUpdate.RowShift();
+            const Int childGridWidth = childUpdate.Grid().Width();
+            Int jLocSplit=0;
+            while( jLocSplit < updateLocWidth && 
+                   myChildRelInds[updateRowShift+jLocSplit*childGridWidth] <
+                   node.size )
+                ++jLocSplit;
+            CommPlan& leadPlan = commMeta.childLeadPlan;
+            CommPlan& trailPlan = commMeta.childTrailPlan;
+            if( !leadPlan.Ready<F>( comm ) || !trailPlan.Ready<F>( comm ) )
             {
-                const Int iFrontLoc = recvInds[2*k+0];
-                const Int jFrontLoc = recvInds[2*k+1];
-                const F value = recvVals[k];
+                std::vector<int> sendLeadCounts(commSize,0), 
+                                 sendTrailCounts(commSize,0);
+                PackChildUpdate
+                ( childUpdate, myChildRelInds, gridHeight, gridWidth, 
+                  0, jLocSplit, (F*)0, sendLeadCounts );
+                PackChildUpdate
+                ( childUpdate, myChildRelInds, gridHeight, gridWidth, 
+                  jLocSplit, updateLocWidth, (F*)0, sendTrailCounts );
+
+                const Int leftLocWidth = front.front2dL.LocalWidth();
+                std::vector<int> recvLeadCounts(commSize), 
+                                 recvTrailCounts(commSize);
+                for( unsigned proc=0; proc<commSize; ++proc )
+                {
+                    const std::vector<Int>& recvInds = 
+                        commMeta.childRecvInds[proc];
+                    const int numRecvInds = recvInds.size()/2;
+                    int k=0;
+                    while( k < numRecvInds && recvInds[2*k+1] < leftLocWidth )
+                        ++k;
+                    recvLeadCounts[proc] = k;
+                    recvTrailCounts[proc] = numRecvInds - k;
+                }
                 DEBUG_ONLY(
-                    const Int iFront = grid.Row() + iFrontLoc*gridHeight;
-                    const Int jFront = grid.Col() + jFrontLoc*gridWidth;
-                    if( iFront < jFront )
-                        LogicError("Tried to update upper triangle");
+                    VerifySendsAndRecvs( sendLeadCounts, recvLeadCounts, comm );
+                    VerifySendsAndRecvs
+                    ( sendTrailCounts, recvTrailCounts, comm );
                 )
-                if( jFrontLoc < leftLocWidth )
-                    front.front2dL.UpdateLocal( iFrontLoc, jFrontLoc, value );
-                else
-                    front.work2d.UpdateLocal
-                    ( iFrontLoc-topLocHeight, jFrontLoc-leftLocWidth, value );
+                leadPlan.Setup<F>( sendLeadCounts, recvLeadCounts, comm, 1, 0 );
+                trailPlan.Setup<F>
+                ( sendTrailCounts, recvTrailCounts, comm, 1, 1 );
             }
-        }
-        SwapClear( recvBuffer );
-        SwapClear( recvCounts );
-        SwapClear( recvDispls );
-        if( computeFactRecvInds )
-            commMeta.EmptyChildRecvIndices();
 
-        // Now that the frontal matrix is set up, perform the factorization
-        if( blocked )
-        {
-            FrontBlockLDL
-            ( front.front2dL, front.work2d, L.isHermitian, pivoted );
-        }
-        else if( pivoted )
-        {
-            DistMatrix<F,MD,STAR> subdiag( grid );
-            front.piv.SetGrid( grid );
-            FrontLDLIntraPiv
-            ( front.front2dL, subdiag, front.piv, front.work2d, L.isHermitian );
-
-            // Store the main and subdiagonals in [VC,* ] distributions
-            auto diag = front.front2dL.GetDiagonal();
-            front.diag1d.SetGrid( grid );
-            front.subdiag1d.SetGrid( grid );
-            front.diag1d = diag;
-            front.subdiag1d = subdiag;
-            El::SetDiagonal( front.front2dL, F(1) );
+            // Start all of the receives before packing, then pack and send 
+            // the leading columns followed by the trailing columns
+            leadPlan.StartRecvs();
+            trailPlan.StartRecvs();
+            std::vector<int> packOffs = leadPlan.SendDispls();
+            PackChildUpdate
+            ( childUpdate, myChildRelInds, gridHeight, gridWidth, 
+              0, jLocSplit, leadPlan.SendBuffer<F>(), packOffs );
+            leadPlan.StartSends();
+            packOffs = trailPlan.SendDispls();
+            PackChildUpdate
+            ( childUpdate, myChildRelInds, gridHeight, gridWidth, 
+              jLocSplit, updateLocWidth, trailPlan.SendBuffer<F>(), packOffs );
+            trailPlan.StartSends();
+            SwapClear( packOffs );
+            childFront.work2d.Empty();
+            if( s == 1 )
+                topLocFront.work.Empty();
+
+            // Unpack the leading pieces as they arrive
+            int proc;
+            while( (proc=leadPlan.WaitAnyRecv()) != -1 )
+                UnpackChildUpdate
+                ( front, leadPlan.LockedRecvBuffer<F>(proc), 
+                  commMeta.childRecvInds[proc], 
+                  0, leadPlan.RecvCounts()[proc] );
+
+            // The leading block of the front is now fully assembled, and the 
+            // trailing updates are additive, so they can be added after the 
+            // Schur complement has been formed
+            FactorDistFront( front, L.isHermitian, blocked, pivoted );
+
+            // Unpack the trailing pieces as they arrive
+            while( (proc=trailPlan.WaitAnyRecv()) != -1 )
+                UnpackChildUpdate
+                ( front, trailPlan.LockedRecvBuffer<F>(proc),
+                  commMeta.childRecvInds[proc], 
+                  leadPlan.RecvCounts()[proc], trailPlan.RecvCounts()[proc] );
+            leadPlan.WaitSends();
+            trailPlan.WaitSends();
         }
         else
         {
-            FrontLDL( front.front2dL, front.work2d, L.isHermitian );
+            CommPlan& plan = commMeta.childUpdatePlan;
+            if( !plan.Ready<F>( comm ) )
+            {
+                std::vector<int> recvCounts(commSize);
+                for( unsigned proc=0; proc<commSize; ++proc )
+                    recvCounts[proc] = commMeta.childRecvInds[proc].size()/2;
+                DEBUG_ONLY(
+                    VerifySendsAndRecvs
+                    ( commMeta.numChildSendInds, recvCounts, comm )
+                )
+                plan.Setup<F>( commMeta.numChildSendInds, recvCounts, comm );
+            }
+
+            // Pack our child's update
+            std::vector<int> packOffs = plan.SendDispls();
+            PackChildUpdate
+            ( childUpdate, myChildRelInds, gridHeight, gridWidth, 
+              0, updateLocWidth, plan.SendBuffer<F>(), packOffs );
+            DEBUG_ONLY(
+                for( unsigned proc=0; proc<commSize; ++proc )
+                {
+                    if( packOffs[proc]-plan.SendDispls()[proc] != 
+                        commMeta.numChildSendInds[proc] )
+                        LogicError("Error in packing stage");
+                }
+            )
+            SwapClear( packOffs );
+            childFront.work2d.Empty();
+            if( s == 1 )
+                topLocFront.work.Empty();
+
+            // Exchange the child updates
+            plan.Exchange();
 
-            // Store the diagonal in a [VC,* ] distribution
-            auto diag = front.front2dL.GetDiagonal();
-            front.diag1d.SetGrid( grid );
-            front.diag1d = diag;
-            El::SetDiagonal( front.front2dL, F(1) );
+            // Unpack the child udpates (with an Axpy)
+            for( unsigned proc=0; proc<commSize; ++proc )
+                UnpackChildUpdate
+                ( front, plan.LockedRecvBuffer<F>(proc), 
+                  commMeta.childRecvInds[proc], 
+                  0, plan.RecvCounts()[proc] );
+
+            // Now that the frontal matrix is set up, perform the factorization
+            FactorDistFront( front, L.isHermitian, blocked, pivoted );
         }
+        if( computeFactRecvInds )
+            commMeta.EmptyChildRecvIndices();
+        if( !keepCommPlans )
+            commMeta.EmptyPlans();
     }
     L.localFronts.back().work.Empty();
     L.distFronts.back().work2d.Empty();
@@ -14,111 +14,261 @@
 
 namespace cliq {
 
-template<typename F> 
-void 
-LocalLDL( DistSymmInfo& info, DistSymmFrontTree<F>& L );
+// If 'threaded' is true and Clique was configured with OpenMP support, then
+// disjoint subtrees of the local elimination tree are factored concurrently
+// as OpenMP tasks (which are load-balanced by the runtime's work-stealing).
+// Otherwise, the update matrices are held in the stack 'L.updateArena' and the
+// local nodes are factored in the order which minimizes its peak size.
+template<typename F>
+void
+LocalLDL( DistSymmInfo& info, DistSymmFrontTree<F>& L, bool threaded=false );
 
 //----------------------------------------------------------------------------//
 // Implementation begins here                                                 //
 //----------------------------------------------------------------------------//
 
-template<typename F> 
-inline void 
-LocalLDL( DistSymmInfo& info, DistSymmFrontTree<F>& L )
+// Subtrees requiring fewer than this many flops are factored by the task which
+// reaches them rather than being split into further tasks
+const double minLocalLDLTaskWork = 1e6;
+
+// Add entries [iStart,end) of a column of a child's update matrix into the
+// corresponding column of the parent front, where front row 'i' is stored in
+// frontCol[i-rowOffset] and 'firstRun' is the run containing 'iStart'
+template<typename F>
+inline void
+ExtendAddColumn
+( const F* childCol, F* frontCol, int rowOffset, int iStart,
+  const std::vector<int>& relInds, const std::vector<int>& runStarts, 
+  int firstRun )
 {
-    DEBUG_ONLY(CallStackEntry cse("LocalLDL"))
+    const int numRuns = runStarts.size()-1;
+    for( int run=firstRun; run<numRuns; ++run )
+    {
+        const int iBeg = std::max( iStart, int(runStarts[run]) );
+        const int runSize = runStarts[run+1] - iBeg;
+        const F* source = &childCol[iBeg];
+        F* target = &frontCol[relInds[iBeg]-rowOffset];
+        for( int k=0; k<runSize; ++k )
+            target[k] += source[k];
+    }
+}
+
+// If 'stacked' is true, then this front's update matrix is placed in
+// L.updateArena (rather than being allocated separately) and is moved down 
+// onto the updates of its children once the front has been factored
+template<typename F>
+inline void
+LocalNodeLDL
+( DistSymmInfo& info, DistSymmFrontTree<F>& L, int s, bool stacked=false )
+{
+    DEBUG_ONLY(CallStackEntry cse("LocalNodeLDL"))
     const bool blockLDL = ( L.frontType == BLOCK_LDL_2D ||
                             L.frontType == BLOCK_LDL_INTRAPIV_2D );
-    const bool intraPiv = ( L.frontType == LDL_INTRAPIV_2D || 
+    const bool intraPiv = ( L.frontType == LDL_INTRAPIV_2D ||
                             L.frontType == BLOCK_LDL_INTRAPIV_2D );
 
-    const int numLocalNodes = info.localNodes.size();
-    for( int s=0; s<numLocalNodes; ++s )
-    {
-        SymmNodeInfo& node = info.localNodes[s];
-        const int updateSize = node.lowerStruct.size();
-        SymmFront<F>& front = L.localFronts[s];
-        Matrix<F>& frontL = front.frontL;
-        Matrix<F>& frontBR = front.work;
-        frontBR.Empty();
-        DEBUG_ONLY(
-            if( frontL.Height() != node.size+updateSize ||
-                frontL.Width() != node.size )
-                LogicError("Front was not the proper size");
-        )
+    SymmNodeInfo& node = info.localNodes[s];
+    const int updateSize = node.lowerStruct.size();
+    SymmFront<F>& front = L.localFronts[s];
+    Matrix<F>& frontL = front.frontL;
+    Matrix<F>& frontBR = front.work;
+    frontBR.Empty();
+    DEBUG_ONLY(
+        if( frontL.Height() != node.size+updateSize ||
+            frontL.Width() != node.size )
+            LogicError("Front was not the proper size");
+    )
 
-        // Add updates from children (if they exist)
+    // Add updates from children (if they exist)
+    UpdateArena<F>& arena = L.updateArena;
+    if( stacked )
+    {
+        frontBR.Attach
+        ( updateSize, updateSize, arena.Buffer(arena.FrontOffset(s)),
+          std::max(updateSize,1) );
+        El::Zero( frontBR );
+    }
+    else
         Zeros( frontBR, updateSize, updateSize );
-        const int numChildren = node.children.size();
-        if( numChildren == 2 )
+    const int numChildren = node.children.size();
+    if( numChildren == 2 )
+    {
+        const int leftInd = node.children[0];
+        const int rightInd = node.children[1];
+        Matrix<F>& leftUpdate = L.localFronts[leftInd].work;
+        Matrix<F>& rightUpdate = L.localFronts[rightInd].work;
+        const int leftUpdateSize = leftUpdate.Height();
+        const int rightUpdateSize = rightUpdate.Height();
+
+        // Since the relative indices are increasing, each child column maps
+        // to a distinct front column, and each maximal run of consecutive
+        // relative indices maps to a contiguous piece of that column
+        const std::vector<int>& leftRunStarts = node.leftRunStarts;
+        const std::vector<int>& rightRunStarts = node.rightRunStarts;
+
+        // Add both children's update matrices in a single pass over the
+        // columns of the front
+        int jLeft=0, jRight=0, leftRun=0, rightRun=0;
+        const int frontSize = node.size + updateSize;
+        for( int jFront=0; jFront<frontSize; ++jFront )
         {
-            const int leftInd = node.children[0];
-            const int rightInd = node.children[1];
-            Matrix<F>& leftUpdate = L.localFronts[leftInd].work;
-            Matrix<F>& rightUpdate = L.localFronts[rightInd].work;
-
-            // Add the left child's update matrix
-            const int leftUpdateSize = leftUpdate.Height();
-            for( int jChild=0; jChild<leftUpdateSize; ++jChild )
+            const bool haveLeft = 
+                ( jLeft < leftUpdateSize && node.leftRelInds[jLeft] == jFront );
+            const bool haveRight = 
+                ( jRight < rightUpdateSize && 
+                  node.rightRelInds[jRight] == jFront );
+            if( !haveLeft && !haveRight )
+                continue;
+
+            // Entries in the upper-triangle are never updated, so the
+            // entire column lies within either frontL or frontBR
+            F* frontCol;
+            int rowOffset;
+            if( jFront < node.size )
             {
-                const int jFront = node.leftRelInds[jChild];
-                for( int iChild=jChild; iChild<leftUpdateSize; ++iChild )
-                {
-                    const int iFront = node.leftRelInds[iChild];
-                    const F value = leftUpdate.Get(iChild,jChild);
-                    DEBUG_ONLY(
-                        if( iFront < jFront )
-                            LogicError("Tried to update upper triangle");
-                    )
-                    if( jFront < node.size )
-                        frontL.Update( iFront, jFront, value );
-                    else if( iFront >= node.size )
-                        frontBR.Update
-                        ( iFront-node.size, jFront-node.size, value );
-                }
+                frontCol = frontL.Buffer(0,jFront);
+                rowOffset = 0;
+            }
+            else
+            {
+                frontCol = frontBR.Buffer(0,jFront-node.size);
+                rowOffset = node.size;
             }
-            leftUpdate.Empty();
 
-            // Add the right child's update matrix
-            const int rightUpdateSize = rightUpdate.Height();
-            for( int jChild=0; jChild<rightUpdateSize; ++jChild )
+            if( haveLeft )
+            {
+                while( leftRunStarts[leftRun+1] <= jLeft )
+                    ++leftRun;
+                ExtendAddColumn
+                ( leftUpdate.LockedBuffer(0,jLeft), frontCol, rowOffset, 
+                  jLeft, node.leftRelInds, leftRunStarts, leftRun );
+                ++jLeft;
+            }
+            if( haveRight )
             {
-                const int jFront = node.rightRelInds[jChild];
-                for( int iChild=jChild; iChild<rightUpdateSize; ++iChild )
-                {
-                    const int iFront = node.rightRelInds[iChild];
-                    const F value = rightUpdate.Get(iChild,jChild);
-                    DEBUG_ONLY(
-                        if( iFront < jFront )
-                            LogicError("Tried to update upper triangle");
-                    )
-                    if( jFront < node.size )
-                        frontL.Update( iFront, jFront, value );
-                    else if( iFront >= node.size )
-                        frontBR.Update
-                        ( iFront-node.size, jFront-node.size, value );
-                }
+                while( rightRunStarts[rightRun+1] <= jRight )
+                    ++rightRun;
+                ExtendAddColumn
+                ( rightUpdate.LockedBuffer(0,jRight), frontCol, rowOffset, 
+                  jRight, node.rightRelInds, rightRunStarts, rightRun );
+                ++jRight;
             }
-            rightUpdate.Empty();
         }
+        DEBUG_ONLY(
+            if( jLeft != leftUpdateSize || jRight != rightUpdateSize )
+                LogicError("Not all child update columns were added");
+        )
+        leftUpdate.Empty();
+        rightUpdate.Empty();
+    }
+
+    // Call the custom partial LDL
+    if( blockLDL )
+        FrontBlockLDL( frontL, frontBR, L.isHermitian, intraPiv );
+    else if( intraPiv )
+    {
+        FrontLDLIntraPiv
+        ( frontL, front.subdiag, front.piv, frontBR, L.isHermitian );
+        frontL.GetDiagonal( front.diag );
+        El::SetDiagonal( frontL, F(1) );
+    }
+    else
+    {
+        FrontLDL( frontL, frontBR, L.isHermitian );
+        frontL.GetDiagonal( front.diag );
+        El::SetDiagonal( frontL, F(1) );
+    }
+
+    // Move our update matrix down onto the stack
+    if( stacked && arena.UpdateOffset(s) != arena.FrontOffset(s) )
+    {
+        // The update never begins above its current position, so it is safe
+        // to copy forward in place
+        F* update = arena.Buffer( arena.UpdateOffset(s) );
+        const F* BRBuf = frontBR.LockedBuffer();
+        const std::size_t numEntries = std::size_t(updateSize)*updateSize;
+        std::copy( BRBuf, BRBuf+numEntries, update );
+        frontBR.Attach
+        ( updateSize, updateSize, update, std::max(updateSize,1) );
+    }
+
+    // The factored front is not needed again until the solves (unless it is
+    // the top local front, which the distributed leaf is a view of)
+    if( L.frontStore.Active() && s != int(info.localNodes.size())-1 )
+        L.frontStore.Offload( s, frontL );
+}
 
-        // Call the custom partial LDL
-        if( blockLDL )
-            FrontBlockLDL( frontL, frontBR, L.isHermitian, intraPiv );
-        else if( intraPiv )
+#ifdef HAVE_OPENMP
+// Factor the subtree rooted at local node 's'. Each child subtree which is
+// large enough is spawned as a task, and the children must all be finished
+// before their update matrices can be extend-added into the parent front.
+//
+// Elemental's debug call stack is shared by all threads, so, in debug builds,
+// each task is executed immediately by the thread which encounters it.
+template<typename F>
+inline void
+LocalSubtreeLDL
+( DistSymmInfo& info, DistSymmFrontTree<F>& L,
+  const std::vector<double>& subtreeWork, int s )
+{
+    bool deferTasks = true;
+    DEBUG_ONLY(deferTasks = false)
+    const SymmNodeInfo& node = info.localNodes[s];
+    const int numChildren = node.children.size();
+    for( int c=0; c<numChildren; ++c )
+    {
+        const int child = node.children[c];
+        #pragma omp task default(shared) firstprivate(child) \
+                if( deferTasks && subtreeWork[child] >= minLocalLDLTaskWork )
+        LocalSubtreeLDL( info, L, subtreeWork, child );
+    }
+    #pragma omp taskwait
+
+    LocalNodeLDL( info, L, s );
+}
+#endif // ifdef HAVE_OPENMP
+
+template<typename F>
+inline void
+LocalLDL( DistSymmInfo& info, DistSymmFrontTree<F>& L, bool threaded )
+{
+    DEBUG_ONLY(CallStackEntry cse("LocalLDL"))
+    const int numLocalNodes = info.localNodes.size();
+#ifdef HAVE_OPENMP
+    if( threaded && numLocalNodes > 1 )
+    {
+        // Estimate the number of flops required by each subtree so that tiny
+        // subtrees are not split into tasks. Since the local nodes are stored
+        // in a post-ordering, each child is visited before its parent.
+        std::vector<double> subtreeWork( numLocalNodes );
+        for( int s=0; s<numLocalNodes; ++s )
         {
-            FrontLDLIntraPiv
-            ( frontL, front.subdiag, front.piv, frontBR, L.isHermitian );
-            frontL.GetDiagonal( front.diag );
-            El::SetDiagonal( frontL, F(1) );
+            const SymmNodeInfo& node = info.localNodes[s];
+            const double n = node.size;
+            const double m = node.lowerStruct.size();
+            subtreeWork[s] = n*n*n/3 + n*n*m + n*m*m;
+            const int numChildren = node.children.size();
+            for( int c=0; c<numChildren; ++c )
+                subtreeWork[s] += subtreeWork[node.children[c]];
         }
-        else
+
+        // The concurrent subtrees allocate their update matrices separately,
+        // so the stack (and any peak recorded by a previous factorization) is
+        // released
+        L.updateArena.Clear();
+        #pragma omp parallel
         {
-            FrontLDL( frontL, frontBR, L.isHermitian );
-            frontL.GetDiagonal( front.diag );
-            El::SetDiagonal( frontL, F(1) );
+            #pragma omp single nowait
+            LocalSubtreeLDL( info, L, subtreeWork, numLocalNodes-1 );
         }
+        return;
     }
+#endif // ifdef HAVE_OPENMP
+    UpdateArena<F>& arena = L.updateArena;
+    arena.Reserve( info );
+    const std::vector<int>& traversal = arena.Traversal();
+    for( int k=0; k<numLocalNodes; ++k )
+        LocalNodeLDL( info, L, traversal[k], true );
 }
 
 } // namespace cliq
@@ -55,6 +55,7 @@ inline void DistLowerMultiplyNormal
         const DistSymmNodeInfo& childNode = info.distNodes[s-1];
         const DistSymmNodeInfo& node = info.distNodes[s];
         const DistSymmFront<T>& childFront = L.distFronts[s-1];
+        L.FetchDistFront( s );
         const DistSymmFront<T>& front = L.distFronts[s];
         const Grid& childGrid = childFront.front1dL.Grid();
         const Grid& grid = front.front1dL.Grid();
@@ -183,6 +184,7 @@ inline void DistLowerMultiplyTranspose
     }
     else
     {
+        L.FetchDistFront( numDistNodes-1 );
         const DistSymmFront<T>& rootFront = L.distFronts.back();
         DistMatrix<T,VC,STAR>& XRoot = X.distNodes.back();
         rootFront.work1d = XRoot;
@@ -194,6 +196,7 @@ inline void DistLowerMultiplyTranspose
         const DistSymmNodeInfo& parentNode = info.distNodes[s+1];
         const DistSymmNodeInfo& node = info.distNodes[s];
         const DistSymmFront<T>& parentFront = L.distFronts[s+1];
+        L.FetchDistFront( s );
         const DistSymmFront<T>& front = L.distFronts[s];
         const Grid& grid = front.front1dL.Grid();
         const Grid& parentGrid = parentFront.front1dL.Grid();
@@ -40,6 +40,7 @@ inline void LocalLowerMultiplyNormal
     for( int s=0; s<numLocalNodes; ++s )
     {
         const SymmNodeInfo& node = info.localNodes[s];
+        L.FetchLocalFront( s );
         const Matrix<T>& frontL = L.localFronts[s].frontL;
         Matrix<T>& W = L.localFronts[s].work;
 
@@ -111,6 +112,7 @@ inline void LocalLowerMultiplyTranspose
     for( int s=numLocalNodes-2; s>=0; --s )
     {
         const SymmNodeInfo& node = info.localNodes[s];
+        L.FetchLocalFront( s );
         const Matrix<T>& frontL = L.localFronts[s].frontL;
         Matrix<T>& W = L.localFronts[s].work;
 
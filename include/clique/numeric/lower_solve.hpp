@@ -14,10 +14,13 @@
 
 namespace cliq {
 
+// If 'mask' is nonzero, then only the subtrees of the elimination tree which 
+// it marks are solved against (see SubtreeMask)
 template<typename F>
 void LowerSolve
 ( Orientation orientation, const DistSymmInfo& info, 
-  const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X );
+  const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X,
+  const SubtreeMask* mask=0 );
 template<typename F>
 void LowerSolve
 ( Orientation orientation, const DistSymmInfo& info, 
@@ -43,19 +46,20 @@ namespace cliq {
 template<typename F>
 inline void LowerSolve
 ( Orientation orientation, const DistSymmInfo& info, 
-  const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X )
+  const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X,
+  const SubtreeMask* mask )
 {
     DEBUG_ONLY(CallStackEntry cse("LowerSolve"))
     if( orientation == NORMAL )
     {
-        LocalLowerForwardSolve( info, L, X );
-        DistLowerForwardSolve( info, L, X );
+        LocalLowerForwardSolve( info, L, X, mask );
+        DistLowerForwardSolve( info, L, X, mask );
     }
     else
     {
         const bool conjugate = ( orientation==ADJOINT );
-        DistLowerBackwardSolve( info, L, X, conjugate );
-        LocalLowerBackwardSolve( info, L, X, conjugate );
+        DistLowerBackwardSolve( info, L, X, conjugate, mask );
+        LocalLowerBackwardSolve( info, L, X, conjugate, mask );
     }
 }
 
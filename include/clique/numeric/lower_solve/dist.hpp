@@ -14,10 +14,13 @@
 
 namespace cliq {
 
+// If 'mask' is nonzero, then only the subtrees which it marks are solved 
+// against (see LocalLowerForwardSolve)
 template<typename F> 
 void DistLowerForwardSolve
 ( const DistSymmInfo& info, 
-  const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X );
+  const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X,
+  const SubtreeMask* mask=0 );
 template<typename F> 
 void DistLowerForwardSolve
 ( const DistSymmInfo& info, 
@@ -27,7 +30,7 @@ template<typename F>
 void DistLowerBackwardSolve
 ( const DistSymmInfo& info, 
   const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X, 
-  bool conjugate=false );
+  bool conjugate=false, const SubtreeMask* mask=0 );
 template<typename F>
 void DistLowerBackwardSolve
 ( const DistSymmInfo& info, 
@@ -41,7 +44,8 @@ void DistLowerBackwardSolve
 template<typename F> 
 inline void DistLowerForwardSolve
 ( const DistSymmInfo& info, 
-  const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X )
+  const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X,
+  const SubtreeMask* mask )
 {
     DEBUG_ONLY(CallStackEntry cse("DistLowerForwardSolve"))
     const int numDistNodes = info.distNodes.size();
@@ -88,6 +92,19 @@ inline void DistLowerForwardSolve
         DistMatrix<F,VC,STAR>& W = front.work1d;
         W.SetGrid( grid );
         W.Resize( frontHeight, width );
+
+        // If neither child subtree is marked, then both child updates are 
+        // zero (as is our portion of the right-hand side), so the exchange
+        // and solve are skipped by the entire team
+        if( mask != 0 && !mask->distNodes[s] )
+        {
+            El::Zero( W );
+            childFront.work1d.Empty();
+            if( s == 1 )
+                L.localFronts.back().work.Empty();
+            continue;
+        }
+        L.FetchDistFront( s );
         DistMatrix<F,VC,STAR> WT(grid), WB(grid);
         PartitionDown( W, WT, WB, node.size );
         WT = X.distNodes[s-1];
@@ -99,61 +116,49 @@ inline void DistLowerForwardSolve
         const int updateSize = childW.Height()-childNode.size;
         DistMatrix<F,VC,STAR> childUpdate( childW.Grid() );
         LockedView( childUpdate, childW, childNode.size, 0, updateSize, width );
-        int sendBufferSize = 0;
-        std::vector<int> sendCounts(commSize), sendDispls(commSize);
-        for( int proc=0; proc<commSize; ++proc )
+
+        // Each row of the update is exchanged as a single block, and the 
+        // plan is reused for every solve with the same number of columns
+        CommPlan& plan = commMeta.forwardPlan;
+        if( !plan.Ready<F>( comm, width ) )
         {
-            const int sendSize = commMeta.numChildSendInds[proc]*width;
-            sendCounts[proc] = sendSize;
-            sendDispls[proc] = sendBufferSize;
-            sendBufferSize += sendSize;
+            std::vector<int> recvCounts(commSize);
+            for( int proc=0; proc<commSize; ++proc )
+                recvCounts[proc] = commMeta.childRecvInds[proc].size();
+            DEBUG_ONLY(
+                VerifySendsAndRecvs( commMeta.numChildSendInds, recvCounts, comm )
+            )
+            plan.Setup<F>( commMeta.numChildSendInds, recvCounts, comm, width );
         }
-        std::vector<F> sendBuffer( sendBufferSize );
+        F* sendBuffer = plan.SendBuffer<F>();
 
         const bool onLeft = childNode.onLeft;
         const std::vector<int>& myChildRelInds = 
             ( onLeft ? node.leftRelInds : node.rightRelInds );
         const int colShift = childUpdate.ColShift();
         const int localHeight = childUpdate.LocalHeight();
-        std::vector<int> packOffs = sendDispls;
+        std::vector<int> packOffs = plan.SendDispls();
         for( int iChildLoc=0; iChildLoc<localHeight; ++iChildLoc )
         {
             const int iChild = colShift + iChildLoc*childCommSize;
             const int destRank = myChildRelInds[iChild] % commSize;
+            F* sendRow = &sendBuffer[packOffs[destRank]*width];
             for( int jChild=0; jChild<width; ++jChild )
-                sendBuffer[packOffs[destRank]++] = 
-                    childUpdate.GetLocal(iChildLoc,jChild);
+                sendRow[jChild] = childUpdate.GetLocal(iChildLoc,jChild);
+            ++packOffs[destRank];
         }
         SwapClear( packOffs );
         childW.Empty();
         if( s == 1 )
             L.localFronts.back().work.Empty();
 
-        // Set up the receive buffer
-        int recvBufferSize = 0;
-        std::vector<int> recvCounts(commSize), recvDispls(commSize);
-        for( int proc=0; proc<commSize; ++proc )
-        {
-            const int recvSize = commMeta.childRecvInds[proc].size()*width;
-            recvCounts[proc] = recvSize;
-            recvDispls[proc] = recvBufferSize;
-            recvBufferSize += recvSize;
-        }
-        std::vector<F> recvBuffer( recvBufferSize );
-        DEBUG_ONLY(VerifySendsAndRecvs( sendCounts, recvCounts, comm ))
-
-        // AllToAll to send and receive the child updates
-        SparseAllToAll
-        ( sendBuffer, sendCounts, sendDispls,
-          recvBuffer, recvCounts, recvDispls, comm );
-        SwapClear( sendBuffer );
-        SwapClear( sendCounts );
-        SwapClear( sendDispls );
+        // Send and receive the child updates
+        plan.Exchange();
 
         // Unpack the child updates (with an Axpy)
         for( int proc=0; proc<commSize; ++proc )
         {
-            const F* recvVals = &recvBuffer[recvDispls[proc]];
+            const F* recvVals = plan.LockedRecvBuffer<F>(proc);
             const std::vector<int>& recvInds = commMeta.childRecvInds[proc];
             for( unsigned k=0; k<recvInds.size(); ++k )
             {
@@ -165,9 +170,6 @@ inline void DistLowerForwardSolve
                     WRow[j*WLDim] += recvRow[j];
             }
         }
-        SwapClear( recvBuffer );
-        SwapClear( recvCounts );
-        SwapClear( recvDispls );
 
         // Now that the RHS is set up, perform this node's solve
         if( frontType == LDL_1D )
@@ -225,6 +227,7 @@ inline void DistLowerForwardSolve
     for( int s=1; s<numDistNodes; ++s )
     {
         const DistSymmNodeInfo& node = info.distNodes[s];
+        L.FetchDistFront( s );
         const DistSymmFront<F>& front = L.distFronts[s];
         const Grid& grid = front.front2dL.Grid();
         const int gridHeight = grid.Height();
@@ -254,16 +257,18 @@ inline void DistLowerForwardSolve
         const int updateSize = childW.Height()-childNode.size;
         DistMatrix<F> childUpdate( childW.Grid() );
         LockedView( childUpdate, childW, childNode.size, 0, updateSize, width );
-        int sendBufferSize = 0;
-        std::vector<int> sendCounts(commSize), sendDispls(commSize);
-        for( int proc=0; proc<commSize; ++proc )
+        CommPlan& plan = commMeta.forwardPlan;
+        if( !plan.Ready<F>( comm ) )
         {
-            const int sendSize = commMeta.numChildSendInds[proc];
-            sendCounts[proc] = sendSize;
-            sendDispls[proc] = sendBufferSize;
-            sendBufferSize += sendSize;
+            std::vector<int> recvCounts(commSize);
+            for( int proc=0; proc<commSize; ++proc )
+                recvCounts[proc] = commMeta.childRecvInds[proc].size()/2;
+            DEBUG_ONLY(
+                VerifySendsAndRecvs( commMeta.numChildSendInds, recvCounts, comm )
+            )
+            plan.Setup<F>( commMeta.numChildSendInds, recvCounts, comm );
         }
-        std::vector<F> sendBuffer( sendBufferSize );
+        F* sendBuffer = plan.SendBuffer<F>();
 
         // Pack send data
         const bool onLeft = childNode.onLeft;
@@ -273,7 +278,7 @@ inline void DistLowerForwardSolve
         const int rowShift = childUpdate.RowShift();
         const int localWidth = childUpdate.LocalWidth();
         const int localHeight = childUpdate.LocalHeight();
-        std::vector<int> packOffs = sendDispls;
+        std::vector<int> packOffs = plan.SendDispls();
         for( int iChildLoc=0; iChildLoc<localHeight; ++iChildLoc )
         {
             const int iChild = colShift + iChildLoc*childGridHeight;
@@ -292,31 +297,13 @@ inline void DistLowerForwardSolve
         if( s == 1 )
             L.localFronts.back().work.Empty();
 
-        // Set up the receive buffer
-        int recvBufferSize = 0;
-        std::vector<int> recvCounts(commSize), recvDispls(commSize);
-        for( int proc=0; proc<commSize; ++proc )
-        {
-            const int recvSize = commMeta.childRecvInds[proc].size()/2;
-            recvCounts[proc] = recvSize;
-            recvDispls[proc] = recvBufferSize;
-            recvBufferSize += recvSize;
-        }
-        std::vector<F> recvBuffer( recvBufferSize );
-        DEBUG_ONLY(VerifySendsAndRecvs( sendCounts, recvCounts, comm ))
-
-        // AllToAll to send and receive the child updates
-        SparseAllToAll
-        ( sendBuffer, sendCounts, sendDispls,
-          recvBuffer, recvCounts, recvDispls, comm );
-        SwapClear( sendBuffer );
-        SwapClear( sendCounts );
-        SwapClear( sendDispls );
+        // Send and receive the child updates
+        plan.Exchange();
 
         // Unpack the child updates (with an Axpy)
         for( int proc=0; proc<commSize; ++proc )
         {
-            const F* recvVals = &recvBuffer[recvDispls[proc]];
+            const F* recvVals = plan.LockedRecvBuffer<F>(proc);
             const std::vector<int>& recvInds = commMeta.childRecvInds[proc];
             for( unsigned k=0; k<recvInds.size()/2; ++k )
             {
@@ -325,9 +312,6 @@ inline void DistLowerForwardSolve
                 W.UpdateLocal( iFrontLoc, jLoc, recvVals[k] );
             }
         }
-        SwapClear( recvBuffer );
-        SwapClear( recvCounts );
-        SwapClear( recvDispls );
 
         // Now that the RHS is set up, perform this node's solve
         if( frontType == LDL_2D )
@@ -353,7 +337,8 @@ inline void DistLowerForwardSolve
 template<typename F>
 inline void DistLowerBackwardSolve
 ( const DistSymmInfo& info, 
-  const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X, bool conjugate )
+  const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X, bool conjugate,
+  const SubtreeMask* mask )
 {
     DEBUG_ONLY(CallStackEntry cse("DistLowerBackwardSolve"))
     const int numDistNodes = info.distNodes.size();
@@ -371,6 +356,8 @@ inline void DistLowerBackwardSolve
 
     // Directly operate on the root separator's portion of the right-hand sides
     const SymmFront<F>& localRootFront = L.localFronts.back();
+    if( mask != 0 && !mask->distNodes.back() )
+        return;
     if( numDistNodes == 1 )
     {
         View( localRootFront.work, X.localNodes.back() );
@@ -387,6 +374,7 @@ inline void DistLowerBackwardSolve
     }
     else
     {
+        L.FetchDistFront( numDistNodes-1 );
         const DistSymmFront<F>& rootFront = L.distFronts.back();
         View( rootFront.work1d, X.distNodes.back() );
         auto& W = rootFront.work1d;
@@ -413,9 +401,14 @@ inline void DistLowerBackwardSolve
 
     for( int s=numDistNodes-2; s>=0; --s )
     {
+        // If the parent is unmarked, then so are both of its children, and 
+        // the entire team of the parent skips the exchange
+        if( mask != 0 && !mask->distNodes[s+1] )
+            continue;
         const DistSymmNodeInfo& parentNode = info.distNodes[s+1];
         const DistSymmNodeInfo& node = info.distNodes[s];
         const DistSymmFront<F>& parentFront = L.distFronts[s+1];
+        L.FetchDistFront( s );
         const DistSymmFront<F>& front = L.distFronts[s];
         const Grid& grid = ( frontsAre1d ? front.front1dL.Grid() 
                                          : front.front2dL.Grid() );
@@ -444,21 +437,24 @@ inline void DistLowerBackwardSolve
 
         // Pack the updates using the recv approach from the forward solve
         const MultiVecCommMeta& commMeta = parentNode.multiVecMeta;
-        int sendBufferSize = 0;
-        std::vector<int> sendCounts(parentCommSize), sendDispls(parentCommSize);
-        for( int proc=0; proc<parentCommSize; ++proc )
+        CommPlan& plan = commMeta.backwardPlan;
+        if( !plan.Ready<F>( parentComm, width ) )
         {
-            const int sendSize = commMeta.childRecvInds[proc].size()*width;
-            sendCounts[proc] = sendSize;
-            sendDispls[proc] = sendBufferSize;
-            sendBufferSize += sendSize;
+            std::vector<int> sendCounts(parentCommSize);
+            for( int proc=0; proc<parentCommSize; ++proc )
+                sendCounts[proc] = commMeta.childRecvInds[proc].size();
+            DEBUG_ONLY(
+                VerifySendsAndRecvs
+                ( sendCounts, commMeta.numChildSendInds, parentComm )
+            )
+            plan.Setup<F>
+            ( sendCounts, commMeta.numChildSendInds, parentComm, width );
         }
-        std::vector<F> sendBuffer( sendBufferSize );
 
         DistMatrix<F,VC,STAR>& parentWork = parentFront.work1d;
         for( int proc=0; proc<parentCommSize; ++proc )
         {
-            F* sendVals = &sendBuffer[sendDispls[proc]];
+            F* sendVals = plan.SendBuffer<F>(proc);
             const std::vector<int>& recvInds = commMeta.childRecvInds[proc];
             for( unsigned k=0; k<recvInds.size(); ++k )
             {
@@ -472,26 +468,8 @@ inline void DistLowerBackwardSolve
         }
         parentWork.Empty();
 
-        // Set up the receive buffer
-        int recvBufferSize = 0;
-        std::vector<int> recvCounts(parentCommSize), recvDispls(parentCommSize);
-        for( int proc=0; proc<parentCommSize; ++proc )
-        {
-            const int recvSize = commMeta.numChildSendInds[proc]*width;
-            recvCounts[proc] = recvSize;
-            recvDispls[proc] = recvBufferSize;
-            recvBufferSize += recvSize;
-        }
-        std::vector<F> recvBuffer( recvBufferSize );
-        DEBUG_ONLY(VerifySendsAndRecvs( sendCounts, recvCounts, parentComm ))
-
-        // AllToAll to send and recv parent updates
-        SparseAllToAll
-        ( sendBuffer, sendCounts, sendDispls,
-          recvBuffer, recvCounts, recvDispls, parentComm );
-        SwapClear( sendBuffer );
-        SwapClear( sendCounts );
-        SwapClear( sendDispls );
+        // Send and recv the parent updates
+        plan.Exchange();
 
         // Unpack the updates using the send approach from the forward solve
         const bool onLeft = node.onLeft;
@@ -499,18 +477,24 @@ inline void DistLowerBackwardSolve
             ( onLeft ? parentNode.leftRelInds : parentNode.rightRelInds );
         const int colShift = WB.ColShift();
         const int localHeight = WB.LocalHeight();
+        std::vector<int> recvOffs( parentCommSize, 0 );
         for( int iUpdateLoc=0; iUpdateLoc<localHeight; ++iUpdateLoc )
         {
             const int iUpdate = colShift + iUpdateLoc*commSize;
             const int startRank = myRelInds[iUpdate] % parentCommSize;
-            const F* recvBuf = &recvBuffer[recvDispls[startRank]];
+            const F* recvBuf = 
+                &plan.LockedRecvBuffer<F>(startRank)[recvOffs[startRank]];
             for( int j=0; j<width; ++j )
                 WB.SetLocal(iUpdateLoc,j,recvBuf[j]);
-            recvDispls[startRank] += width;
+            recvOffs[startRank] += width;
+        }
+
+        // Our sibling's subtree may be marked even if ours is not
+        if( mask != 0 && !mask->distNodes[s] )
+        {
+            W.Empty();
+            continue;
         }
-        SwapClear( recvBuffer );
-        SwapClear( recvCounts );
-        SwapClear( recvDispls );
 
         // Call the custom node backward solve
         if( s > 0 )
@@ -589,6 +573,7 @@ inline void DistLowerBackwardSolve
     }
     else
     {
+        L.FetchDistFront( numDistNodes-1 );
         const DistSymmFront<F>& rootFront = L.distFronts.back();
         View( rootFront.work2d, X.distNodes.back() );
 
@@ -614,6 +599,7 @@ inline void DistLowerBackwardSolve
         const DistSymmNodeInfo& parentNode = info.distNodes[s+1];
         const DistSymmNodeInfo& node = info.distNodes[s];
         const DistSymmFront<F>& parentFront = L.distFronts[s+1];
+        L.FetchDistFront( s );
         const DistSymmFront<F>& front = L.distFronts[s];
         const Grid& grid = front.front2dL.Grid();
         const int gridHeight = grid.Height(); 
@@ -641,23 +627,25 @@ inline void DistLowerBackwardSolve
 
         // Pack the updates using the recv approach from the forward solve
         const MatrixCommMeta& commMeta = X.commMetas[s];
-        int sendBufferSize = 0;
-        std::vector<int> sendCounts(parentCommSize), sendDispls(parentCommSize);
-        for( int proc=0; proc<parentCommSize; ++proc )
+        CommPlan& plan = commMeta.backwardPlan;
+        if( !plan.Ready<F>( parentComm ) )
         {
             // childRecvInds contains pairs of indices, but we will send one
             // floating-point value per pair
-            const int sendSize = commMeta.childRecvInds[proc].size()/2;
-            sendCounts[proc] = sendSize;
-            sendDispls[proc] = sendBufferSize;
-            sendBufferSize += sendSize;
+            std::vector<int> sendCounts(parentCommSize);
+            for( int proc=0; proc<parentCommSize; ++proc )
+                sendCounts[proc] = commMeta.childRecvInds[proc].size()/2;
+            DEBUG_ONLY(
+                VerifySendsAndRecvs
+                ( sendCounts, commMeta.numChildSendInds, parentComm )
+            )
+            plan.Setup<F>( sendCounts, commMeta.numChildSendInds, parentComm );
         }
-        std::vector<F> sendBuffer( sendBufferSize );
 
         DistMatrix<F>& parentWork = parentFront.work2d;
         for( int proc=0; proc<parentCommSize; ++proc )
         {
-            F* sendVals = &sendBuffer[sendDispls[proc]];
+            F* sendVals = plan.SendBuffer<F>(proc);
             const std::vector<int>& recvInds = commMeta.childRecvInds[proc];
             for( unsigned k=0; k<recvInds.size()/2; ++k )
             {
@@ -668,26 +656,10 @@ inline void DistLowerBackwardSolve
         }
         parentWork.Empty();
 
-        // Set up the receive buffer
-        int recvBufferSize = 0;
-        std::vector<int> recvCounts(parentCommSize), recvDispls(parentCommSize);
-        for( int proc=0; proc<parentCommSize; ++proc )
-        {
-            const int recvSize = commMeta.numChildSendInds[proc];
-            recvCounts[proc] = recvSize;
-            recvDispls[proc] = recvBufferSize;
-            recvBufferSize += recvSize;
-        }
-        std::vector<F> recvBuffer( recvBufferSize );
-        DEBUG_ONLY(VerifySendsAndRecvs( sendCounts, recvCounts, parentComm ))
-
-        // AllToAll to send and recv parent updates
-        SparseAllToAll
-        ( sendBuffer, sendCounts, sendDispls,
-          recvBuffer, recvCounts, recvDispls, parentComm );
-        SwapClear( sendBuffer );
-        SwapClear( sendCounts );
-        SwapClear( sendDispls );
+        // Send and recv the parent updates
+        plan.Exchange();
+        std::vector<int> recvDispls = plan.RecvDispls();
+        const F* recvBuffer = plan.LockedRecvBuffer<F>();
 
         // Unpack the updates using the send approach from the forward solve
         const bool onLeft = node.onLeft;
@@ -710,8 +682,6 @@ inline void DistLowerBackwardSolve
                 ( iUpdateLoc, jLoc, recvBuffer[recvDispls[startRank]++] );
             }
         }
-        SwapClear( recvBuffer );
-        SwapClear( recvCounts );
         SwapClear( recvDispls );
 
         // Call the custom node backward solve
@@ -14,10 +14,15 @@
 
 namespace cliq {
 
+// If 'mask' is nonzero, then only the subtrees which it marks are solved 
+// against (in the forward solve, the unmarked subtrees should have zero
+// right-hand sides, and, in the backward solve, the solution is left
+// unspecified within them)
 template<typename F> 
 void LocalLowerForwardSolve
 ( const DistSymmInfo& info, 
-  const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X );
+  const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X,
+  const SubtreeMask* mask=0 );
 template<typename F> 
 void LocalLowerForwardSolve
 ( const DistSymmInfo& info, 
@@ -27,7 +32,7 @@ template<typename F>
 void LocalLowerBackwardSolve
 ( const DistSymmInfo& info, 
   const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X,
-  bool conjugate=false );
+  bool conjugate=false, const SubtreeMask* mask=0 );
 template<typename F> 
 void LocalLowerBackwardSolve
 ( const DistSymmInfo& info, 
@@ -38,10 +43,95 @@ void LocalLowerBackwardSolve
 // Implementation begins here                                                 //
 //----------------------------------------------------------------------------//
 
+// Updates with fewer entries than this are added by a single thread
+const int minParallelExtendAddEntries = 1<<14;
+
+// W(relInds[i],:) += update(i,:) for each row i of the update. Since the 
+// relative indices are increasing, each run of consecutive relative indices
+// (see ContiguousRuns) maps to a contiguous piece of each column of W, so the
+// innermost loop is a unit-stride loop over rows. Each thread handles a 
+// disjoint set of columns, so no synchronization is required.
+template<typename F>
+inline void
+ExtendAddUpdate
+( const Matrix<F>& update, const std::vector<int>& relInds, 
+  const std::vector<int>& runStarts, Matrix<F>& W )
+{
+    DEBUG_ONLY(
+        CallStackEntry cse("ExtendAddUpdate");
+        if( update.Width() != W.Width() )
+            LogicError("Update and workspace widths did not match");
+    )
+    const int width = W.Width();
+    const int numRuns = runStarts.size()-1;
+    const F* updateBuf = update.LockedBuffer();
+    const int updateLDim = update.LDim();
+    F* WBuf = W.Buffer();
+    const int WLDim = W.LDim();
+#ifdef HAVE_OPENMP
+    #pragma omp parallel for schedule(static) \
+            if( double(update.Height())*width >= minParallelExtendAddEntries )
+#endif
+    for( int j=0; j<width; ++j )
+    {
+        const F* updateCol = &updateBuf[j*updateLDim];
+        F* WCol = &WBuf[j*WLDim];
+        for( int run=0; run<numRuns; ++run )
+        {
+            const int iBeg = runStarts[run];
+            const int runSize = runStarts[run+1] - iBeg;
+            const F* source = &updateCol[iBeg];
+            F* target = &WCol[relInds[iBeg]];
+            for( int k=0; k<runSize; ++k )
+                target[k] += source[k];
+        }
+    }
+}
+
+// WB(i,:) = parentWork(relInds[i],:) for each row i of WB, which is the 
+// reverse of ExtendAddUpdate (with an overwrite rather than an addition)
+template<typename F>
+inline void
+GatherUpdate
+( const Matrix<F>& parentWork, const std::vector<int>& relInds, 
+  const std::vector<int>& runStarts, Matrix<F>& WB )
+{
+    DEBUG_ONLY(
+        CallStackEntry cse("GatherUpdate");
+        if( parentWork.Width() != WB.Width() )
+            LogicError("Parent and workspace widths did not match");
+    )
+    const int width = WB.Width();
+    const int numRuns = runStarts.size()-1;
+    const F* parentBuf = parentWork.LockedBuffer();
+    const int parentLDim = parentWork.LDim();
+    F* WBBuf = WB.Buffer();
+    const int WBLDim = WB.LDim();
+#ifdef HAVE_OPENMP
+    #pragma omp parallel for schedule(static) \
+            if( double(WB.Height())*width >= minParallelExtendAddEntries )
+#endif
+    for( int j=0; j<width; ++j )
+    {
+        const F* parentCol = &parentBuf[j*parentLDim];
+        F* WBCol = &WBBuf[j*WBLDim];
+        for( int run=0; run<numRuns; ++run )
+        {
+            const int iBeg = runStarts[run];
+            const int runSize = runStarts[run+1] - iBeg;
+            const F* source = &parentCol[relInds[iBeg]];
+            F* target = &WBCol[iBeg];
+            for( int k=0; k<runSize; ++k )
+                target[k] = source[k];
+        }
+    }
+}
+
 template<typename F> 
 inline void LocalLowerForwardSolve
 ( const DistSymmInfo& info, 
-  const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X )
+  const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X,
+  const SubtreeMask* mask )
 {
     DEBUG_ONLY(CallStackEntry cse("LocalLowerForwardSolve"))
     const int numLocalNodes = info.localNodes.size();
@@ -52,16 +142,39 @@ inline void LocalLowerForwardSolve
         LogicError("Nonsensical front type for solve");
     const bool blocked = BlockFactorization( frontType );
     const bool pivoted = PivotedFactorization( frontType );
+    SolveArena<F>& arena = L.solveArena;
+    arena.Reserve( info, width );
 
     for( int s=0; s<numLocalNodes; ++s )
     {
         const SymmNodeInfo& node = info.localNodes[s];
         const SymmFront<F>& front = L.localFronts[s];
-        const Matrix<F>& frontL = front.frontL;
         Matrix<F>& W = front.work;
 
+        // A subtree with a zero right-hand side has a zero solution, and 
+        // contributes a zero update (which the distributed solve expects from 
+        // the top local front)
+        if( mask != 0 && !mask->localNodes[s] )
+        {
+            if( s == numLocalNodes-1 )
+            {
+                const int frontHeight = node.size + node.lowerStruct.size();
+                W.Attach
+                ( frontHeight, width, arena.Buffer(arena.ForwardOffset(s)),
+                  std::max(frontHeight,1) );
+                El::Zero( W );
+            }
+            continue;
+        }
+
+        L.FetchLocalFront( s );
+        const Matrix<F>& frontL = front.frontL;
+        const int frontHeight = frontL.Height();
+
         // Set up a workspace
-        W.Resize( frontL.Height(), width );
+        W.Attach
+        ( frontHeight, width, arena.Buffer(arena.ForwardOffset(s)), 
+          std::max(frontHeight,1) );
         Matrix<F> WT, WB;
         PartitionDown( W, WT, WB, node.size );
         WT = X.localNodes[s];
@@ -75,33 +188,34 @@ inline void LocalLowerForwardSolve
             const int rightInd = node.children[1];
             Matrix<F>& leftWork = L.localFronts[leftInd].work;
             Matrix<F>& rightWork = L.localFronts[rightInd].work;
-            const int leftNodeSize = info.localNodes[leftInd].size;
-            const int rightNodeSize = info.localNodes[rightInd].size;
-            const int leftUpdateSize = leftWork.Height()-leftNodeSize;
-            const int rightUpdateSize = rightWork.Height()-rightNodeSize;
+            // (the children's workspaces now only hold their updates)
+            // (and the unmarked children's updates are zero)
+            const bool haveLeft = ( mask == 0 || mask->localNodes[leftInd] );
+            const bool haveRight = 
+                ( mask == 0 || mask->localNodes[rightInd] );
+            DEBUG_ONLY(
+                if( (haveLeft && 
+                     leftWork.Height() != int(node.leftRelInds.size())) ||
+                    (haveRight && 
+                     rightWork.Height() != int(node.rightRelInds.size())) )
+                    LogicError("Child updates were not the proper size");
+            )
 
             // Add the left child's update onto ours
-            auto leftUpdate = 
-                LockedView( leftWork, leftNodeSize, 0, leftUpdateSize, width );
-            for( int iChild=0; iChild<leftUpdateSize; ++iChild )
+            if( haveLeft )
             {
-                const int iFront = node.leftRelInds[iChild]; 
-                for( int j=0; j<width; ++j )
-                    W.Update( iFront, j, leftUpdate.Get(iChild,j) );
+                ExtendAddUpdate
+                ( leftWork, node.leftRelInds, node.leftRunStarts, W );
+                leftWork.Empty();
             }
-            leftWork.Empty();
 
             // Add the right child's update onto ours
-            auto rightUpdate =
-                LockedView
-                ( rightWork, rightNodeSize, 0, rightUpdateSize, width );
-            for( int iChild=0; iChild<rightUpdateSize; ++iChild )
+            if( haveRight )
             {
-                const int iFront = node.rightRelInds[iChild];
-                for( int j=0; j<width; ++j )
-                    W.Update( iFront, j, rightUpdate.Get(iChild,j) );
+                ExtendAddUpdate
+                ( rightWork, node.rightRelInds, node.rightRunStarts, W );
+                rightWork.Empty();
             }
-            rightWork.Empty();
         }
         // else numChildren == 0
 
@@ -115,6 +229,22 @@ inline void LocalLowerForwardSolve
 
         // Store this node's portion of the result
         X.localNodes[s] = WT;
+
+        // Pack our update down onto the stack (the workspace of the root of
+        // the local tree is instead consumed by the distributed solve)
+        if( s < numLocalNodes-1 )
+        {
+            const int updateSize = frontHeight - node.size;
+            F* update = arena.Buffer( arena.UpdateOffset(s) );
+            const F* WBuf = W.LockedBuffer();
+            const int WLDim = W.LDim();
+            // The update never begins above the workspace, so it is safe to
+            // copy forward in place
+            for( int j=0; j<width; ++j )
+                for( int i=0; i<updateSize; ++i )
+                    update[i+j*updateSize] = WBuf[node.size+i+j*WLDim];
+            W.Attach( updateSize, width, update, std::max(updateSize,1) );
+        }
     }
 }
 
@@ -133,16 +263,22 @@ inline void LocalLowerForwardSolve
         LogicError("Nonsensical front type for solve");
     const bool blocked = BlockFactorization( frontType );
     const bool pivoted = PivotedFactorization( frontType );
+    SolveArena<F>& arena = L.solveArena;
+    arena.Reserve( info, width );
 
     for( int s=0; s<numLocalNodes; ++s )
     {
         const SymmNodeInfo& node = info.localNodes[s];
+        L.FetchLocalFront( s );
         const SymmFront<F>& front = L.localFronts[s];
         const Matrix<F>& frontL = front.frontL;
         Matrix<F>& W = front.work;
+        const int frontHeight = frontL.Height();
 
         // Set up a workspace
-        W.Resize( frontL.Height(), width );
+        W.Attach
+        ( frontHeight, width, arena.Buffer(arena.ForwardOffset(s)), 
+          std::max(frontHeight,1) );
         Matrix<F> WT, WB;
         PartitionDown( W, WT, WB, node.size );
         WT = X.localNodes[s];
@@ -156,32 +292,21 @@ inline void LocalLowerForwardSolve
             const int rightInd = node.children[1];
             Matrix<F>& leftWork = L.localFronts[leftInd].work;
             Matrix<F>& rightWork = L.localFronts[rightInd].work;
-            const int leftNodeSize = info.localNodes[leftInd].size;
-            const int rightNodeSize = info.localNodes[rightInd].size;
-            const int leftUpdateSize = leftWork.Height()-leftNodeSize;
-            const int rightUpdateSize = rightWork.Height()-rightNodeSize;
+            // (the children's workspaces now only hold their updates)
+            DEBUG_ONLY(
+                if( leftWork.Height() != int(node.leftRelInds.size()) ||
+                    rightWork.Height() != int(node.rightRelInds.size()) )
+                    LogicError("Child updates were not the proper size");
+            )
 
             // Add the left child's update onto ours
-            auto leftUpdate =
-                LockedView( leftWork, leftNodeSize, 0, leftUpdateSize, width );
-            for( int iChild=0; iChild<leftUpdateSize; ++iChild )
-            {
-                const int iFront = node.leftRelInds[iChild]; 
-                for( int j=0; j<width; ++j )
-                    W.Update( iFront, j, leftUpdate.Get(iChild,j) );
-            }
+            ExtendAddUpdate
+            ( leftWork, node.leftRelInds, node.leftRunStarts, W );
             leftWork.Empty();
 
             // Add the right child's update onto ours
-            auto rightUpdate =
-                LockedView
-                ( rightWork, rightNodeSize, 0, rightUpdateSize, width );
-            for( int iChild=0; iChild<rightUpdateSize; ++iChild )
-            {
-                const int iFront = node.rightRelInds[iChild];
-                for( int j=0; j<width; ++j )
-                    W.Update( iFront, j, rightUpdate.Get(iChild,j) );
-            }
+            ExtendAddUpdate
+            ( rightWork, node.rightRelInds, node.rightRunStarts, W );
             rightWork.Empty();
         }
         // else numChildren == 0
@@ -196,6 +321,22 @@ inline void LocalLowerForwardSolve
 
         // Store this node's portion of the result
         X.localNodes[s] = WT;
+
+        // Pack our update down onto the stack (the workspace of the root of
+        // the local tree is instead consumed by the distributed solve)
+        if( s < numLocalNodes-1 )
+        {
+            const int updateSize = frontHeight - node.size;
+            F* update = arena.Buffer( arena.UpdateOffset(s) );
+            const F* WBuf = W.LockedBuffer();
+            const int WLDim = W.LDim();
+            // The update never begins above the workspace, so it is safe to
+            // copy forward in place
+            for( int j=0; j<width; ++j )
+                for( int i=0; i<updateSize; ++i )
+                    update[i+j*updateSize] = WBuf[node.size+i+j*WLDim];
+            W.Attach( updateSize, width, update, std::max(updateSize,1) );
+        }
     }
 }
 
@@ -203,7 +344,7 @@ template<typename F>
 inline void LocalLowerBackwardSolve
 ( const DistSymmInfo& info, 
   const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X,
-  bool conjugate )
+  bool conjugate, const SubtreeMask* mask )
 {
     DEBUG_ONLY(CallStackEntry cse("LocalLowerBackwardSolve"))
     const int numLocalNodes = info.localNodes.size();
@@ -214,16 +355,26 @@ inline void LocalLowerBackwardSolve
         LogicError("Nonsensical front type for solve");
     const bool blocked = BlockFactorization( frontType );
     const bool pivoted = PivotedFactorization( frontType );
+    SolveArena<F>& arena = L.solveArena;
+    arena.Reserve( info, width );
 
     for( int s=numLocalNodes-2; s>=0; --s )
     {
+        // The parent of each marked node is also marked, so the unmarked 
+        // nodes are never read from
+        if( mask != 0 && !mask->localNodes[s] )
+            continue;
         const SymmNodeInfo& node = info.localNodes[s];
+        L.FetchLocalFront( s );
         const SymmFront<F>& front = L.localFronts[s];
         const Matrix<F>& frontL = front.frontL;
         Matrix<F>& W = front.work;
+        const int frontHeight = frontL.Height();
 
         // Set up a workspace
-        W.Resize( frontL.Height(), width );
+        W.Attach
+        ( frontHeight, width, arena.Buffer(arena.BackwardOffset(s)), 
+          std::max(frontHeight,1) );
         Matrix<F> WT, WB;
         PartitionDown( W, WT, WB, node.size );
         WT = X.localNodes[s];
@@ -239,15 +390,16 @@ inline void LocalLowerBackwardSolve
         )
         Matrix<F>& parentWork = L.localFronts[parent].work;
         const SymmNodeInfo& parentNode = info.localNodes[parent];
-        const int currentUpdateSize = WB.Height();
         const std::vector<int>& parentRelInds = 
           ( node.onLeft ? parentNode.leftRelInds : parentNode.rightRelInds );
-        for( int iCurrent=0; iCurrent<currentUpdateSize; ++iCurrent )
-        {
-            const int iParent = parentRelInds[iCurrent];
-            for( int j=0; j<width; ++j )
-                WB.Set( iCurrent, j, parentWork.Get(iParent,j) );
-        }
+        const std::vector<int>& parentRunStarts = 
+          ( node.onLeft ? parentNode.leftRunStarts 
+                        : parentNode.rightRunStarts );
+        DEBUG_ONLY(
+            if( int(parentRelInds.size()) != WB.Height() )
+                LogicError("Relative indices were not the proper size");
+        )
+        GatherUpdate( parentWork, parentRelInds, parentRunStarts, WB );
 
         // The left child is numbered lower than the right child, so 
         // we can safely free the parent's work if we are the left child
@@ -258,6 +410,19 @@ inline void LocalLowerBackwardSolve
                 L.distFronts[0].work1d.Empty();
         }
 
+        // Move our workspace down onto our parent's (if it is in the arena)
+        const int finalOff = arena.BackwardFinalOffset( s );
+        if( finalOff != arena.BackwardOffset( s ) )
+        {
+            F* finalBuf = arena.Buffer( finalOff );
+            const F* WBuf = W.LockedBuffer();
+            const std::size_t numEntries = std::size_t(frontHeight)*width;
+            for( std::size_t k=0; k<numEntries; ++k )
+                finalBuf[k] = WBuf[k];
+            W.Attach( frontHeight, width, finalBuf, std::max(frontHeight,1) );
+            PartitionDown( W, WT, WB, node.size );
+        }
+
         // Solve against this front
         if( blocked )
             FrontBlockLowerBackwardSolve( frontL, W, conjugate );
@@ -291,16 +456,22 @@ inline void LocalLowerBackwardSolve
         LogicError("Nonsensical front type for solve");
     const bool blocked = BlockFactorization( frontType );
     const bool pivoted = PivotedFactorization( frontType );
+    SolveArena<F>& arena = L.solveArena;
+    arena.Reserve( info, width );
 
     for( int s=numLocalNodes-2; s>=0; --s )
     {
         const SymmNodeInfo& node = info.localNodes[s];
+        L.FetchLocalFront( s );
         const SymmFront<F>& front = L.localFronts[s];
         const Matrix<F>& frontL = front.frontL;
         Matrix<F>& W = front.work;
+        const int frontHeight = frontL.Height();
 
         // Set up a workspace
-        W.Resize( frontL.Height(), width );
+        W.Attach
+        ( frontHeight, width, arena.Buffer(arena.BackwardOffset(s)), 
+          std::max(frontHeight,1) );
         Matrix<F> WT, WB;
         PartitionDown( W, WT, WB, node.size );
         WT = X.localNodes[s];
@@ -316,15 +487,16 @@ inline void LocalLowerBackwardSolve
         )
         Matrix<F>& parentWork = L.localFronts[parent].work;
         const SymmNodeInfo& parentNode = info.localNodes[parent];
-        const int currentUpdateSize = WB.Height();
         const std::vector<int>& parentRelInds = 
           ( node.onLeft ? parentNode.leftRelInds : parentNode.rightRelInds );
-        for( int iCurrent=0; iCurrent<currentUpdateSize; ++iCurrent )
-        {
-            const int iParent = parentRelInds[iCurrent];
-            for( int j=0; j<width; ++j )
-                WB.Set( iCurrent, j, parentWork.Get(iParent,j) );
-        }
+        const std::vector<int>& parentRunStarts = 
+          ( node.onLeft ? parentNode.leftRunStarts 
+                        : parentNode.rightRunStarts );
+        DEBUG_ONLY(
+            if( int(parentRelInds.size()) != WB.Height() )
+                LogicError("Relative indices were not the proper size");
+        )
+        GatherUpdate( parentWork, parentRelInds, parentRunStarts, WB );
 
         // The left child is numbered lower than the right child, so 
         // we can safely free the parent's work if we are the left child
@@ -335,6 +507,19 @@ inline void LocalLowerBackwardSolve
                 L.distFronts[0].work2d.Empty();
         }
 
+        // Move our workspace down onto our parent's (if it is in the arena)
+        const int finalOff = arena.BackwardFinalOffset( s );
+        if( finalOff != arena.BackwardOffset( s ) )
+        {
+            F* finalBuf = arena.Buffer( finalOff );
+            const F* WBuf = W.LockedBuffer();
+            const std::size_t numEntries = std::size_t(frontHeight)*width;
+            for( std::size_t k=0; k<numEntries; ++k )
+                finalBuf[k] = WBuf[k];
+            W.Attach( frontHeight, width, finalBuf, std::max(frontHeight,1) );
+            PartitionDown( W, WT, WB, node.size );
+        }
+
         // Solve against this front
         if( blocked )
             FrontBlockLowerBackwardSolve( frontL, W, conjugate );
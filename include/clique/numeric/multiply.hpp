@@ -24,6 +24,52 @@ void Multiply
 // Implementation begins here                                                 //
 //----------------------------------------------------------------------------//
 
+// The number of right-hand sides which are accumulated at once for each row
+const int multiplyColBlocksize = 8;
+
+// Y(iLocal,:) += alpha sum_e A(e) X(colOffs[e],:), where e runs over 
+// entries[rowOffs[iLocal]:rowOffs[iLocal+1]-1] and X(i,j) is stored in 
+// XBuf[i*XRowStride+j*XColStride]
+template<typename T>
+inline void
+MultiplyRows
+( T alpha, const T* values, 
+  const std::vector<int>& rowOffs, const std::vector<int>& entries, 
+  const std::vector<int>& colOffs,
+  const T* XBuf, int XRowStride, int XColStride,
+        T* YBuf, int YLDim, int width )
+{
+    const int localHeight = rowOffs.size()-1;
+#ifdef HAVE_OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for( int iLocal=0; iLocal<localHeight; ++iLocal )
+    {
+        const int entryBeg = rowOffs[iLocal];
+        const int entryEnd = rowOffs[iLocal+1];
+        if( entryBeg == entryEnd )
+            continue;
+        for( int jBeg=0; jBeg<width; jBeg+=multiplyColBlocksize )
+        {
+            const int nb = std::min(multiplyColBlocksize,width-jBeg);
+            T Z[multiplyColBlocksize];
+            for( int j=0; j<nb; ++j )
+                Z[j] = 0;
+            for( int k=entryBeg; k<entryEnd; ++k )
+            {
+                const int e = entries[k];
+                const T AVal = values[e];
+                const T* XRow = &XBuf[colOffs[e]*XRowStride+jBeg*XColStride];
+                for( int j=0; j<nb; ++j )
+                    Z[j] += AVal*XRow[j*XColStride];
+            }
+            T* YRow = &YBuf[iLocal+jBeg*YLDim];
+            for( int j=0; j<nb; ++j )
+                YRow[j*YLDim] += alpha*Z[j];
+        }
+    }
+}
+
 template<typename T>
 void Multiply
 ( T alpha, const DistSparseMatrix<T>& A, const DistMultiVec<T>& X,
@@ -39,95 +85,32 @@ void Multiply
             LogicError("Communicators did not match");
     )
     mpi::Comm comm = A.Comm();
-    const int commSize = mpi::Size( comm );
     const int YLocalHeight = Y.LocalHeight();
     const int width = X.Width();
-    const int numLocalEntries = A.NumLocalEntries();
 
     // Y := beta Y
+    Matrix<T>& YLoc = Y.LocalMatrix();
+    T* YBuf = YLoc.Buffer();
+    const int YLDim = YLoc.LDim();
     for( int j=0; j<width; ++j )
         for( int iLocal=0; iLocal<YLocalHeight; ++iLocal )
-            Y.SetLocal( iLocal, j, beta*Y.GetLocal(iLocal,j) );
+            YBuf[iLocal+j*YLDim] *= beta;
 
     SparseMultMeta<T>& meta = A.multMeta;
     if( !meta.ready )
-    {
-        // Compute the set of row indices that we need from X
-        std::set<int> indexSet;
-        for( int e=0; e<numLocalEntries; ++e )
-            indexSet.insert( A.Col(e) );
-        const int numRecvInds = indexSet.size();
-        std::vector<int> recvInds( numRecvInds );
-        meta.recvSizes.clear();
-        meta.recvSizes.resize( commSize, 0 );
-        meta.recvOffs.resize( commSize );
-        const int blocksize = A.Blocksize();
-        {
-            int off=0, lastOff=0, qPrev=0;
-            std::set<int>::const_iterator setIt;
-            for( setIt=indexSet.begin(); setIt!=indexSet.end(); ++setIt )
-            {
-                const int j = *setIt;
-                const int q = RowToProcess( j, blocksize, commSize );
-                while( qPrev != q )
-                {
-                    meta.recvSizes[qPrev] = off - lastOff;
-                    meta.recvOffs[qPrev+1] = off;
-    
-                    lastOff = off;
-                    ++qPrev;
-                }
-                recvInds[off++] = j;
-            }
-            while( qPrev != commSize-1 )
-            {
-                meta.recvSizes[qPrev] = off - lastOff;
-                meta.recvOffs[qPrev+1] = off;
-                lastOff = off;
-                ++qPrev;
-            }
-            meta.recvSizes[commSize-1] = off - lastOff;
-        }
-
-        // Coordinate
-        meta.sendSizes.resize( commSize );
-        mpi::AllToAll( &meta.recvSizes[0], 1, &meta.sendSizes[0], 1, comm );
-        int numSendInds=0;
-        meta.sendOffs.resize( commSize );
-        for( int q=0; q<commSize; ++q )
-        {
-            meta.sendOffs[q] = numSendInds;
-            numSendInds += meta.sendSizes[q];
-        }
-        meta.sendInds.resize( numSendInds );
-        mpi::AllToAll
-        ( &recvInds[0],       &meta.recvSizes[0], &meta.recvOffs[0],
-          &meta.sendInds[0], &meta.sendSizes[0], &meta.sendOffs[0], comm );
-
-        meta.colOffs.resize( numLocalEntries );
-        for( int s=0; s<numLocalEntries; ++s )
-            meta.colOffs[s] = Find( recvInds, A.Col(s) );
-        meta.numRecvInds = numRecvInds;
-        meta.ready = true;
-    }
-
-    // Convert the sizes and offsets to be compatible with the current width
-    std::vector<int> recvSizes=meta.recvSizes,
-                     recvOffs=meta.recvOffs,
-                     sendSizes=meta.sendSizes,
-                     sendOffs=meta.sendOffs;
-    for( int q=0; q<commSize; ++q )
-    {
-        recvSizes[q] *= width;    
-        recvOffs[q] *= width;
-        sendSizes[q] *= width;
-        sendOffs[q] *= width;
-    }
+        BuildSparseMultMeta( A );
+    CommPlan& plan = meta.plan;
+    if( !plan.Ready<T>( comm, width ) )
+        plan.Setup<T>( meta.sendSizes, meta.recvSizes, comm, width );
 
-    // Pack the send values
+    // Pack the send values and start the halo exchange
+    plan.StartRecvs();
+    const Matrix<T>& XLoc = X.LockedLocalMatrix();
+    const T* XBuf = XLoc.LockedBuffer();
+    const int XLDim = XLoc.LDim();
     const int numSendInds = meta.sendInds.size();
     const int firstLocalRow = A.FirstLocalRow();
-    std::vector<T> sendVals( numSendInds*width );
+    T* sendVals = plan.SendBuffer<T>();
     for( int s=0; s<numSendInds; ++s )
     {
         const int i = meta.sendInds[s];
@@ -137,32 +120,21 @@ void Multiply
                 LogicError("iLocal was out of bounds");
         )
         for( int j=0; j<width; ++j )
-            sendVals[s*width+j] = X.GetLocal( iLocal, j );
+            sendVals[s*width+j] = XBuf[iLocal+j*XLDim];
     }
-
-    // Now send them
-    std::vector<T> recvVals( meta.numRecvInds*width );
-    mpi::AllToAll
-    ( &sendVals[0], &sendSizes[0], &sendOffs[0],
-      &recvVals[0], &recvSizes[0], &recvOffs[0], comm );
+    plan.StartSends();
      
-    // Perform the local multiply-accumulate, y := alpha A x + y
-    for( int iLocal=0; iLocal<YLocalHeight; ++iLocal )
-    {
-        const int off = A.LocalEntryOffset( iLocal );
-        const int rowSize = A.NumConnections( iLocal );
-        for( int k=0; k<rowSize; ++k )
-        {
-            const int colOff = meta.colOffs[k+off];
-            const T AVal = A.Value(k+off);
-            for( int j=0; j<width; ++j )
-            {
-                const T XVal = recvVals[colOff*width+j];
-                const T update = alpha*AVal*XVal;
-                Y.UpdateLocal( iLocal, j, update );
-            }
-        }
-    }
+    // Perform the local multiply-accumulate, y := alpha A x + y, starting 
+    // with the entries which do not depend upon the exchange
+    const T* values = A.LockedValueBuffer();
+    MultiplyRows
+    ( alpha, values, meta.localRowOffs, meta.localEntries, meta.colOffs,
+      XBuf, 1, XLDim, YBuf, YLDim, width );
+    plan.WaitRecvs();
+    MultiplyRows
+    ( alpha, values, meta.haloRowOffs, meta.haloEntries, meta.colOffs,
+      plan.LockedRecvBuffer<T>(), width, 1, YBuf, YLDim, width );
+    plan.WaitSends();
 }
 
 } // namespace cliq
@@ -0,0 +1,284 @@
+/*
+   Copyright (c) 2009-2014, Jack Poulson, Lexing Ying,
+   The University of Texas at Austin, Stanford University, and the
+   Georgia Insitute of Technology.
+   All rights reserved.
+ 
+   This file is part of Clique and is under the BSD 2-Clause License, 
+   which can be found in the LICENSE file in the root directory, or at 
+   http://opensource.org/licenses/BSD-2-Clause
+*/
+#pragma once
+#ifndef CLIQ_NUMERIC_REFINEDSOLVE_HPP
+#define CLIQ_NUMERIC_REFINEDSOLVE_HPP
+
+namespace cliq {
+
+// Overwrite X with the solution of A X = B, where X initially holds B and L 
+// holds a factorization of A (computed with the ordering whose inverse is
+// 'inverseMap'), and then iteratively refine X until the largest 
+// componentwise backward error,
+//
+//     max_i |B - A X|_i / (|A| |X| + |B|)_i,
+//
+// of its columns is at most 'tol', until a step fails to halve it (in which
+// case the step is undone), or until 'maxRefineIts' steps have been taken. 
+// The number of refinement steps which were kept is returned and the 
+// backward error of the final X is stored in 'backwardError'.
+template<typename F>
+int RefinedSolve
+( const DistSparseMatrix<F>& A, const DistMap& inverseMap,
+  const DistSymmInfo& info, const DistSymmFrontTree<F>& L,
+  DistMultiVec<F>& X, Base<F>& backwardError,
+  Base<F> tol=std::numeric_limits<Base<F>>::epsilon(), int maxRefineIts=10 );
+
+// Factor a single-precision copy of the (real or complex) double-precision
+// matrix A and recover double-precision accuracy with the iterative 
+// refinement of RefinedSolve, where each residual is formed in double
+// precision and the corrections are solved for in single precision. The 
+// number of refinement steps which were kept is returned.
+template<typename F>
+int SymmetricMixedSolve
+( const DistSparseMatrix<F>& A, DistMultiVec<F>& X,
+  bool conjugate=false, int maxRefineIts=10,
+  bool sequential=true, int numDistSeps=1, int numSeqSeps=1, int cutoff=128 );
+template<typename F>
+int HermitianMixedSolve
+( const DistSparseMatrix<F>& A, DistMultiVec<F>& X,
+  int maxRefineIts=10,
+  bool sequential=true, int numDistSeps=1, int numSeqSeps=1, int cutoff=128 );
+
+//----------------------------------------------------------------------------//
+// Implementation begins here                                                 //
+//----------------------------------------------------------------------------//
+
+namespace internal {
+
+// Overwrite X with inv(A) X, where the nodal form of X is stored in the
+// workspace which matches the type of the fronts
+template<typename F>
+inline void
+NodalSolve
+( const DistMap& inverseMap, const DistSymmInfo& info, 
+  const DistSymmFrontTree<F>& L, DistMultiVec<F>& X,
+  DistNodalMultiVec<F>& XNodal1d, DistNodalMatrix<F>& XNodal2d )
+{
+    if( FrontsAre1d(L.frontType) )
+    {
+        XNodal1d.Pull( inverseMap, info, X );
+        Solve( info, L, XNodal1d );
+        XNodal1d.Push( inverseMap, info, X );
+    }
+    else
+    {
+        XNodal2d.Pull( inverseMap, info, X );
+        Solve( info, L, XNodal2d );
+        XNodal2d.Push( inverseMap, info, X );
+    }
+}
+
+// The largest componentwise backward error of the columns of X, given the
+// residual R = B - A X and Z = |A| |X| + |B|
+template<typename F>
+inline Base<F>
+MaxBackwardError
+( const DistMultiVec<F>& R, const DistMultiVec<Base<F>>& Z )
+{
+    typedef Base<F> Real;
+    const int localHeight = R.LocalHeight();
+    const int width = R.Width();
+    Real localError = 0;
+    for( int j=0; j<width; ++j )
+    {
+        for( int iLocal=0; iLocal<localHeight; ++iLocal )
+        {
+            const Real rho = Abs(R.GetLocal(iLocal,j));
+            const Real zeta = Z.GetLocal(iLocal,j);
+            if( zeta != Real(0) )
+                localError = std::max( localError, rho/zeta );
+            else if( rho != Real(0) )
+                localError = std::numeric_limits<Real>::infinity();
+        }
+    }
+    return mpi::AllReduce( localError, mpi::MAX, R.Comm() );
+}
+
+// Overwrite X, which initially holds B, with solve(X) and then iteratively 
+// refine it as described for RefinedSolve, where solve(R) overwrites R with
+// an approximation of inv(A) R
+template<typename F,typename SolveFunctor>
+inline int
+Refine
+( const DistSparseMatrix<F>& A, DistMultiVec<F>& X, const SolveFunctor& solve,
+  Base<F>& backwardError, Base<F> tol, int maxRefineIts )
+{
+    DEBUG_ONLY(
+        CallStackEntry cse("Refine");
+        if( A.Height() != X.Height() )
+            LogicError("A and X must be the same height");
+    )
+    typedef Base<F> Real;
+    mpi::Comm comm = A.Comm();
+    const int localHeight = X.LocalHeight();
+    const int width = X.Width();
+
+    // Form |A| with the same distribution as A
+    const int numLocalEntries = A.NumLocalEntries();
+    std::vector<int> localEntryOffsets( A.LocalHeight()+1 );
+    for( int iLocal=0; iLocal<=A.LocalHeight(); ++iLocal )
+        localEntryOffsets[iLocal] = A.LocalEntryOffset( iLocal );
+    std::vector<int> targets( numLocalEntries );
+    std::vector<Real> absValues( numLocalEntries );
+    for( int e=0; e<numLocalEntries; ++e )
+    {
+        targets[e] = A.Col( e );
+        absValues[e] = Abs(A.Value(e));
+    }
+    DistSparseMatrix<Real> AAbs
+    ( A.Height(), A.Width(), comm, std::move(localEntryOffsets), 
+      std::move(targets), std::move(absValues) );
+
+    // The residual and |B| are reused by every step
+    DistMultiVec<F> B, R, XLast;
+    DistMultiVec<Real> BAbs, XAbs, Z;
+    B = X;
+    BAbs.SetComm( comm );
+    BAbs.Resize( X.Height(), width );
+    for( int j=0; j<width; ++j )
+        for( int iLocal=0; iLocal<localHeight; ++iLocal )
+            BAbs.SetLocal( iLocal, j, Abs(B.GetLocal(iLocal,j)) );
+    Convert( BAbs, XAbs );
+    solve( X );
+
+    int numRefineIts = 0;
+    Real lastBackwardError = 0;
+    while( true )
+    {
+        // R := B - A X and Z := |A| |X| + |B|
+        Convert( B, R );
+        Multiply( F(-1), A, X, F(1), R );
+        for( int j=0; j<width; ++j )
+            for( int iLocal=0; iLocal<localHeight; ++iLocal )
+                XAbs.SetLocal( iLocal, j, Abs(X.GetLocal(iLocal,j)) );
+        Convert( BAbs, Z );
+        Multiply( Real(1), AAbs, XAbs, Real(1), Z );
+        backwardError = MaxBackwardError( R, Z );
+
+        // Undo a step which did not halve the backward error (the comparison
+        // is negated so that a NaN is also rejected)
+        if( numRefineIts > 0 && !(backwardError <= lastBackwardError/2) )
+        {
+            X = XLast;
+            backwardError = lastBackwardError;
+            --numRefineIts;
+            break;
+        }
+        if( backwardError <= tol || numRefineIts == maxRefineIts )
+            break;
+
+        // X := X + inv(A) R
+        solve( R );
+        XLast = X;
+        Axpy( F(1), R, X );
+        lastBackwardError = backwardError;
+        ++numRefineIts;
+    }
+    return numRefineIts;
+}
+
+} // namespace internal
+
+template<typename F>
+inline int
+RefinedSolve
+( const DistSparseMatrix<F>& A, const DistMap& inverseMap,
+  const DistSymmInfo& info, const DistSymmFrontTree<F>& L,
+  DistMultiVec<F>& X, Base<F>& backwardError,
+  Base<F> tol, int maxRefineIts )
+{
+    DEBUG_ONLY(CallStackEntry cse("RefinedSolve"))
+    // The nodal workspaces are reused by every step
+    DistNodalMultiVec<F> XNodal1d;
+    DistNodalMatrix<F> XNodal2d;
+    auto solve = [&]( DistMultiVec<F>& Y )
+    { internal::NodalSolve( inverseMap, info, L, Y, XNodal1d, XNodal2d ); };
+    return internal::Refine( A, X, solve, backwardError, tol, maxRefineIts );
+}
+
+template<typename F>
+inline int SymmetricMixedSolve
+( const DistSparseMatrix<F>& A, DistMultiVec<F>& X,
+  bool conjugate, int maxRefineIts,
+  bool sequential, int numDistSeps, int numSeqSeps, int cutoff )
+{
+    DEBUG_ONLY(CallStackEntry cse("SymmetricMixedSolve"))
+    typedef Base<F> Real;
+    typedef typename Demote<F>::type S;
+    DistSymmInfo info;
+    DistSeparatorTree sepTree;
+    DistMap map, inverseMap;
+    NestedDissection
+    ( A.LockedDistGraph(), map, sepTree, info, 
+      sequential, numDistSeps, numSeqSeps, cutoff );
+    map.FormInverse( inverseMap );
+
+    DistSymmFrontTree<S> frontTree;
+    {
+        DistSparseMatrix<S> ASingle;
+        Convert( A, ASingle );
+        frontTree.Initialize( ASingle, map, sepTree, info, conjugate, false );
+    }
+    LDL( info, frontTree, LDL_INTRAPIV_1D );
+
+    // Each column is scaled to unit norm before it is demoted (and unscaled 
+    // after it is promoted) so that the shrinking residuals neither underflow
+    // nor lose their relative accuracy in single precision
+    const int localHeight = X.LocalHeight();
+    const int width = X.Width();
+    DistMultiVec<S> YSingle;
+    DistNodalMultiVec<S> YNodal;
+    std::vector<Real> YNorms;
+    auto solve = [&]( DistMultiVec<F>& Y )
+    {
+        Norms( Y, YNorms );
+        for( int j=0; j<width; ++j )
+        {
+            if( YNorms[j] == Real(0) )
+                continue;
+            const Real scale = Real(1)/YNorms[j];
+            for( int iLocal=0; iLocal<localHeight; ++iLocal )
+                Y.SetLocal( iLocal, j, scale*Y.GetLocal(iLocal,j) );
+        }
+        Convert( Y, YSingle );
+        YNodal.Pull( inverseMap, info, YSingle );
+        Solve( info, frontTree, YNodal );
+        YNodal.Push( inverseMap, info, YSingle );
+        Convert( YSingle, Y );
+        for( int j=0; j<width; ++j )
+        {
+            if( YNorms[j] == Real(0) )
+                continue;
+            for( int iLocal=0; iLocal<localHeight; ++iLocal )
+                Y.SetLocal( iLocal, j, YNorms[j]*Y.GetLocal(iLocal,j) );
+        }
+    };
+    Real backwardError;
+    return internal::Refine
+    ( A, X, solve, backwardError, std::numeric_limits<Real>::epsilon(), 
+      maxRefineIts );
+}
+
+template<typename F>
+inline int HermitianMixedSolve
+( const DistSparseMatrix<F>& A, DistMultiVec<F>& X,
+  int maxRefineIts,
+  bool sequential, int numDistSeps, int numSeqSeps, int cutoff )
+{
+    DEBUG_ONLY(CallStackEntry cse("HermitianMixedSolve"))
+    return SymmetricMixedSolve
+    ( A, X, true, maxRefineIts, sequential, numDistSeps, numSeqSeps, cutoff );
+}
+
+} // namespace cliq
+
+#endif // ifndef CLIQ_NUMERIC_REFINEDSOLVE_HPP
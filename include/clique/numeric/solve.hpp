@@ -23,6 +23,29 @@ void Solve
 ( const DistSymmInfo& info, 
   const DistSymmFrontTree<F>& L, DistNodalMatrix<F>& X );
 
+// Solve against right-hand sides which are zero outside of the subtrees marked
+// by 'rhsMask' when the solution is only required within the subtrees marked
+// by 'solutionMask' (see MarkNonzeroSubtrees). The forward solve skips the 
+// subtrees which are not marked by 'rhsMask', and the backward solve skips 
+// those which are not marked by 'solutionMask' (where the solution is left 
+// unspecified).
+template<typename F>
+void Solve
+( const DistSymmInfo& info, 
+  const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X,
+  const SubtreeMask& rhsMask, const SubtreeMask& solutionMask );
+
+// Overwrite X with the solution when its columns are nonzero in only a few 
+// rows and only the rows 'requestedRows' (in the original ordering) of the 
+// solution are required. Each process need only list the requested rows which
+// it owns (the others are ignored), and the remaining rows of the solution are
+// left unspecified.
+template<typename F>
+void SparseSolve
+( const DistMap& inverseMap, const DistSymmInfo& info,
+  const DistSymmFrontTree<F>& L, DistMultiVec<F>& X,
+  const std::vector<int>& requestedRows );
+
 template<typename F>
 void SymmetricSolve
 ( const DistSparseMatrix<F>& A, DistMultiVec<F>& X,
@@ -91,6 +114,62 @@ inline void Solve
     }
 }
 
+template<typename F>
+inline void Solve
+( const DistSymmInfo& info, 
+  const DistSymmFrontTree<F>& L, DistNodalMultiVec<F>& X,
+  const SubtreeMask& rhsMask, const SubtreeMask& solutionMask )
+{
+    DEBUG_ONLY(CallStackEntry cse("Solve"))
+    if( !FrontsAre1d(L.frontType) )
+        LogicError("Invalid front type for 1D solve");
+    const Orientation orientation = ( L.isHermitian ? ADJOINT : TRANSPOSE );
+    if( BlockFactorization(L.frontType) )
+    {
+        LowerSolve( NORMAL, info, L, X, &rhsMask );
+        LowerSolve( orientation, info, L, X, &solutionMask );
+    }
+    else
+    {
+        LowerSolve( NORMAL, info, L, X, &rhsMask );
+        DiagonalSolve( info, L, X );
+        LowerSolve( orientation, info, L, X, &solutionMask );
+    }
+}
+
+template<typename F>
+inline void SparseSolve
+( const DistMap& inverseMap, const DistSymmInfo& info,
+  const DistSymmFrontTree<F>& L, DistMultiVec<F>& X,
+  const std::vector<int>& requestedRows )
+{
+    DEBUG_ONLY(CallStackEntry cse("SparseSolve"))
+    DistNodalMultiVec<F> XNodal( inverseMap, info, X );
+    SubtreeMask rhsMask, solutionMask;
+    MarkNonzeroSubtrees( info, XNodal, rhsMask );
+
+    // Mark the requested rows with a single column in the original ordering
+    // and map it onto the elimination tree
+    {
+        DistMultiVec<F> requested( X.Height(), 1, X.Comm() );
+        Zero( requested );
+        const int firstLocalRow = requested.FirstLocalRow();
+        const int localHeight = requested.LocalHeight();
+        const int numRequested = requestedRows.size();
+        for( int k=0; k<numRequested; ++k )
+        {
+            const int iLocal = requestedRows[k] - firstLocalRow;
+            if( iLocal >= 0 && iLocal < localHeight )
+                requested.SetLocal( iLocal, 0, F(1) );
+        }
+        DistNodalMultiVec<F> requestedNodal( inverseMap, info, requested );
+        MarkNonzeroSubtrees( info, requestedNodal, solutionMask );
+    }
+
+    Solve( info, L, XNodal, rhsMask, solutionMask );
+    XNodal.Push( inverseMap, info, X );
+}
+
 template<typename F>
 inline void SymmetricSolve
 ( const DistSparseMatrix<F>& A, DistMultiVec<F>& X, 
@@ -106,7 +185,8 @@ inline void SymmetricSolve
       sequential, numDistSeps, numSeqSeps, cutoff );
     map.FormInverse( inverseMap );
 
-    DistSymmFrontTree<F> frontTree( A, map, sepTree, info, conjugate );
+    // The fronts are never refilled, so the fill pattern is not kept
+    DistSymmFrontTree<F> frontTree( A, map, sepTree, info, conjugate, false );
     LDL( info, frontTree, LDL_INTRAPIV_1D );
 
     DistNodalMultiVec<F> XNodal;
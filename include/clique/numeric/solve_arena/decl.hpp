@@ -0,0 +1,65 @@
+/*
+   Copyright (c) 2009-2014, Jack Poulson, Lexing Ying,
+   The University of Texas at Austin, Stanford University, and the
+   Georgia Insitute of Technology.
+   All rights reserved.
+ 
+   This file is part of Clique and is under the BSD 2-Clause License, 
+   which can be found in the LICENSE file in the root directory, or at 
+   http://opensource.org/licenses/BSD-2-Clause
+*/
+#pragma once
+#ifndef CLIQ_NUMERIC_SOLVEARENA_DECL_HPP
+#define CLIQ_NUMERIC_SOLVEARENA_DECL_HPP
+
+namespace cliq {
+
+// A single buffer which holds the workspaces of the local fronts during the
+// solves, so that they are views rather than separate allocations. The
+// workspaces are laid out as a stack which follows the (postordered) 
+// traversal of the local tree:
+//
+//  - In the forward solve, each front's workspace is pushed above the updates
+//    of its children, and, once it has been solved against, its own update 
+//    is packed down onto the position of its children's updates. The 
+//    workspace of the root of the local tree is left in place since it is
+//    consumed by the distributed solve.
+//
+//  - In the backward solve, each front's workspace is pushed above that of 
+//    its parent, and the left child (which is visited last) is then moved 
+//    down onto its parent's workspace, which it has just consumed. 
+//
+// Each offset is measured in rows, and each row holds 'width' entries.
+template<typename F>
+class SolveArena
+{
+public:
+    SolveArena();
+
+    // Lay out the local tree of 'info' and ensure that there is room for
+    // 'width' right-hand sides (the buffer only grows until Free is called)
+    void Reserve( const DistSymmInfo& info, int width );
+    void Free();
+
+    // The number of entries in the buffer
+    std::size_t Capacity() const;
+    // The number of rows needed by the local solves
+    int PeakRows() const;
+
+    int ForwardOffset( int s ) const;
+    int UpdateOffset( int s ) const;
+    int BackwardOffset( int s ) const;
+    int BackwardFinalOffset( int s ) const;
+
+    F* Buffer( int rowOffset );
+
+private:
+    int width_, peakRows_;
+    std::vector<int> forwardOffs_, updateOffs_, 
+                     backwardOffs_, backwardFinalOffs_;
+    std::vector<F> buffer_;
+};
+
+} // namespace cliq
+
+#endif // ifndef CLIQ_NUMERIC_SOLVEARENA_DECL_HPP
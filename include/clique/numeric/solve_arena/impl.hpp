@@ -0,0 +1,145 @@
+/*
+   Copyright (c) 2009-2014, Jack Poulson, Lexing Ying,
+   The University of Texas at Austin, Stanford University, and the
+   Georgia Insitute of Technology.
+   All rights reserved.
+ 
+   This file is part of Clique and is under the BSD 2-Clause License, 
+   which can be found in the LICENSE file in the root directory, or at 
+   http://opensource.org/licenses/BSD-2-Clause
+*/
+#pragma once
+#ifndef CLIQ_NUMERIC_SOLVEARENA_IMPL_HPP
+#define CLIQ_NUMERIC_SOLVEARENA_IMPL_HPP
+
+namespace cliq {
+
+template<typename F>
+inline
+SolveArena<F>::SolveArena()
+: width_(0), peakRows_(0)
+{ }
+
+template<typename F>
+inline void
+SolveArena<F>::Reserve( const DistSymmInfo& info, int width )
+{
+    DEBUG_ONLY(CallStackEntry cse("SolveArena::Reserve"))
+    const int numLocalNodes = info.localNodes.size();
+    forwardOffs_.resize( numLocalNodes );
+    updateOffs_.resize( numLocalNodes );
+    backwardOffs_.resize( numLocalNodes );
+    backwardFinalOffs_.resize( numLocalNodes );
+    peakRows_ = 0;
+
+    // Simulate the forward solve
+    int top = 0;
+    for( int s=0; s<numLocalNodes; ++s )
+    {
+        const SymmNodeInfo& node = info.localNodes[s];
+        const int updateSize = node.lowerStruct.size();
+        const int frontHeight = node.size + updateSize;
+        int base = top;
+        if( node.children.size() == 2 )
+        {
+            const int left = node.children[0];
+            base = updateOffs_[left];
+            DEBUG_ONLY(
+                const int right = node.children[1];
+                const int leftUpdateSize = 
+                    info.localNodes[left].lowerStruct.size();
+                if( updateOffs_[right] != base+leftUpdateSize ||
+                    top != updateOffs_[right]+
+                           int(info.localNodes[right].lowerStruct.size()) )
+                    LogicError("Local nodes were not in postorder");
+            )
+        }
+        forwardOffs_[s] = top;
+        peakRows_ = std::max( peakRows_, top+frontHeight );
+        if( s < numLocalNodes-1 )
+        {
+            updateOffs_[s] = base;
+            top = base + updateSize;
+        }
+        else
+            updateOffs_[s] = top;
+    }
+
+    // Simulate the backward solve (the root's workspace is not in the arena)
+    top = 0;
+    if( numLocalNodes > 0 )
+    {
+        backwardOffs_[numLocalNodes-1] = 0;
+        backwardFinalOffs_[numLocalNodes-1] = 0;
+    }
+    for( int s=numLocalNodes-2; s>=0; --s )
+    {
+        const SymmNodeInfo& node = info.localNodes[s];
+        const int frontHeight = node.size + node.lowerStruct.size();
+        backwardOffs_[s] = top;
+        peakRows_ = std::max( peakRows_, top+frontHeight );
+        if( node.onLeft && node.parent != numLocalNodes-1 )
+            backwardFinalOffs_[s] = backwardFinalOffs_[node.parent];
+        else
+            backwardFinalOffs_[s] = top;
+        top = backwardFinalOffs_[s] + frontHeight;
+        if( node.children.empty() )
+            top = backwardFinalOffs_[s];
+    }
+
+    width_ = width;
+    const std::size_t numEntries = std::size_t(peakRows_)*width;
+    if( buffer_.size() < numEntries )
+        buffer_.resize( numEntries );
+}
+
+template<typename F>
+inline void
+SolveArena<F>::Free()
+{
+    width_ = peakRows_ = 0;
+    SwapClear( forwardOffs_ );
+    SwapClear( updateOffs_ );
+    SwapClear( backwardOffs_ );
+    SwapClear( backwardFinalOffs_ );
+    SwapClear( buffer_ );
+}
+
+template<typename F>
+inline std::size_t
+SolveArena<F>::Capacity() const
+{ return buffer_.size(); }
+
+template<typename F>
+inline int
+SolveArena<F>::PeakRows() const
+{ return peakRows_; }
+
+template<typename F>
+inline int
+SolveArena<F>::ForwardOffset( int s ) const
+{ return forwardOffs_[s]; }
+
+template<typename F>
+inline int
+SolveArena<F>::UpdateOffset( int s ) const
+{ return updateOffs_[s]; }
+
+template<typename F>
+inline int
+SolveArena<F>::BackwardOffset( int s ) const
+{ return backwardOffs_[s]; }
+
+template<typename F>
+inline int
+SolveArena<F>::BackwardFinalOffset( int s ) const
+{ return backwardFinalOffs_[s]; }
+
+template<typename F>
+inline F*
+SolveArena<F>::Buffer( int rowOffset )
+{ return buffer_.data() + std::size_t(rowOffset)*width_; }
+
+} // namespace cliq
+
+#endif // ifndef CLIQ_NUMERIC_SOLVEARENA_IMPL_HPP
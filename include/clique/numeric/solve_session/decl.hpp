@@ -0,0 +1,88 @@
+/*
+   Copyright (c) 2009-2014, Jack Poulson, Lexing Ying,
+   The University of Texas at Austin, Stanford University, and the
+   Georgia Insitute of Technology.
+   All rights reserved.
+ 
+   This file is part of Clique and is under the BSD 2-Clause License, 
+   which can be found in the LICENSE file in the root directory, or at 
+   http://opensource.org/licenses/BSD-2-Clause
+*/
+#pragma once
+#ifndef CLIQ_NUMERIC_SOLVESESSION_DECL_HPP
+#define CLIQ_NUMERIC_SOLVESESSION_DECL_HPP
+
+namespace cliq {
+
+// Accumulates the right-hand sides of many small solves against the same
+// factorization into panels of a fixed width so that each panel is solved by
+// a single call to Solve, which trades latency for the much higher flop rates
+// of wide solves. Each submitted multi-vector is overwritten with its 
+// solution once the panel containing it is solved, and the caller is then 
+// notified through either a future or a callback.
+//
+// Submit and Flush are collective: every process must submit multi-vectors 
+// of the same widths in the same order.
+template<typename F>
+class SolveSession
+{
+public:
+    typedef std::function<void(DistMultiVec<F>&)> Callback;
+
+    // The arguments must remain valid for the lifetime of the session
+    SolveSession
+    ( const DistMap& inverseMap, const DistSymmInfo& info, 
+      const DistSymmFrontTree<F>& L, int panelWidth=64 );
+    // The requests which are still queued are not solved: their futures
+    // receive a std::runtime_error and their callbacks are not called, so
+    // Flush should be called first
+    ~SolveSession();
+
+    // X must remain valid until its solution has been delivered. Multi-vectors
+    // which are wider than a panel are solved immediately, and those with no
+    // columns are delivered in order without a solve. If a callback throws,
+    // the remaining requests of its panel are still delivered before the 
+    // first exception is rethrown.
+    std::future<void> Submit( DistMultiVec<F>& X );
+    void Submit( DistMultiVec<F>& X, Callback callback );
+
+    // Solve the partially-filled panel (if there is one)
+    void Flush();
+
+    int PanelWidth() const;
+    int NumQueued() const;
+    int NumPanelsSolved() const;
+
+private:
+    struct Request
+    {
+        DistMultiVec<F>* X;
+        int offset;
+        bool hasPromise;
+        std::promise<void> promise;
+        Callback callback;
+    };
+
+    const DistMap& inverseMap_;
+    const DistSymmInfo& info_;
+    const DistSymmFrontTree<F>& L_;
+    int panelWidth_, numQueued_, numPanelsSolved_;
+
+    // The panel and nodal workspaces are reused by every solve
+    DistMultiVec<F> panel_, partialPanel_;
+    DistNodalMultiVec<F> nodal1d_;
+    DistNodalMatrix<F> nodal2d_;
+    std::vector<Request> requests_;
+
+    SolveSession( const SolveSession& session );
+    const SolveSession& operator=( const SolveSession& session );
+
+    void Enqueue( Request& request );
+    void Deliver( Request& request );
+    static void CopyColumns
+    ( const DistMultiVec<F>& A, int jA, DistMultiVec<F>& B, int jB, int width );
+};
+
+} // namespace cliq
+
+#endif // ifndef CLIQ_NUMERIC_SOLVESESSION_DECL_HPP
@@ -0,0 +1,237 @@
+/*
+   Copyright (c) 2009-2014, Jack Poulson, Lexing Ying,
+   The University of Texas at Austin, Stanford University, and the
+   Georgia Insitute of Technology.
+   All rights reserved.
+ 
+   This file is part of Clique and is under the BSD 2-Clause License, 
+   which can be found in the LICENSE file in the root directory, or at 
+   http://opensource.org/licenses/BSD-2-Clause
+*/
+#pragma once
+#ifndef CLIQ_NUMERIC_SOLVESESSION_IMPL_HPP
+#define CLIQ_NUMERIC_SOLVESESSION_IMPL_HPP
+
+namespace cliq {
+
+template<typename F>
+inline
+SolveSession<F>::SolveSession
+( const DistMap& inverseMap, const DistSymmInfo& info, 
+  const DistSymmFrontTree<F>& L, int panelWidth )
+: inverseMap_(inverseMap), info_(info), L_(L), 
+  panelWidth_(panelWidth), numQueued_(0), numPanelsSolved_(0)
+{
+    DEBUG_ONLY(CallStackEntry cse("SolveSession::SolveSession"))
+    if( panelWidth < 1 )
+        LogicError("Panel width must be positive");
+}
+
+template<typename F>
+inline
+SolveSession<F>::~SolveSession()
+{
+    // Flush is collective and may throw, so the pending requests are failed
+    // rather than solved
+    const int numRequests = requests_.size();
+    for( int k=0; k<numRequests; ++k )
+    {
+        if( requests_[k].hasPromise )
+        {
+            std::runtime_error error
+            ("SolveSession was destroyed before the request was solved");
+            requests_[k].promise.set_exception
+            ( std::make_exception_ptr(error) );
+        }
+    }
+}
+
+template<typename F>
+inline std::future<void>
+SolveSession<F>::Submit( DistMultiVec<F>& X )
+{
+    DEBUG_ONLY(CallStackEntry cse("SolveSession::Submit"))
+    Request request;
+    request.X = &X;
+    request.hasPromise = true;
+    std::future<void> future = request.promise.get_future();
+    Enqueue( request );
+    return future;
+}
+
+template<typename F>
+inline void
+SolveSession<F>::Submit( DistMultiVec<F>& X, Callback callback )
+{
+    DEBUG_ONLY(CallStackEntry cse("SolveSession::Submit"))
+    Request request;
+    request.X = &X;
+    request.hasPromise = false;
+    request.callback = callback;
+    Enqueue( request );
+}
+
+template<typename F>
+inline void
+SolveSession<F>::Flush()
+{
+    DEBUG_ONLY(CallStackEntry cse("SolveSession::Flush"))
+    if( requests_.empty() )
+        return;
+
+    // Callbacks may submit more right-hand sides, so the queue is emptied
+    // and all of the solutions are copied out before anyone is notified
+    std::vector<Request> requests;
+    requests.swap( requests_ );
+    const int numQueued = numQueued_;
+    numQueued_ = 0;
+    if( numQueued > 0 )
+    {
+        DistMultiVec<F>* panel = &panel_;
+        if( numQueued < panelWidth_ )
+        {
+            if( !mpi::Congruent( panel_.Comm(), partialPanel_.Comm() ) )
+                partialPanel_.SetComm( panel_.Comm() );
+            partialPanel_.Resize( panel_.Height(), numQueued );
+            CopyColumns( panel_, 0, partialPanel_, 0, numQueued );
+            panel = &partialPanel_;
+        }
+        try 
+        { 
+            internal::NodalSolve
+            ( inverseMap_, info_, L_, *panel, nodal1d_, nodal2d_ ); 
+        }
+        catch( ... )
+        {
+            for( std::size_t k=0; k<requests.size(); ++k )
+                if( requests[k].hasPromise )
+                    requests[k].promise.set_exception
+                    ( std::current_exception() );
+            throw;
+        }
+        ++numPanelsSolved_;
+        for( std::size_t k=0; k<requests.size(); ++k )
+        {
+            DistMultiVec<F>& X = *requests[k].X;
+            CopyColumns( *panel, requests[k].offset, X, 0, X.Width() );
+        }
+    }
+
+    // Notify everyone before rethrowing the first exception from a callback
+    std::exception_ptr callbackException;
+    for( std::size_t k=0; k<requests.size(); ++k )
+    {
+        try { Deliver( requests[k] ); }
+        catch( ... )
+        {
+            if( !callbackException )
+                callbackException = std::current_exception();
+        }
+    }
+    if( callbackException )
+        std::rethrow_exception( callbackException );
+}
+
+template<typename F>
+inline int
+SolveSession<F>::PanelWidth() const
+{ return panelWidth_; }
+
+template<typename F>
+inline int
+SolveSession<F>::NumQueued() const
+{ return numQueued_; }
+
+template<typename F>
+inline int
+SolveSession<F>::NumPanelsSolved() const
+{ return numPanelsSolved_; }
+
+template<typename F>
+inline void
+SolveSession<F>::Enqueue( Request& request )
+{
+    DEBUG_ONLY(CallStackEntry cse("SolveSession::Enqueue"))
+    DistMultiVec<F>& X = *request.X;
+    const int width = X.Width();
+    // (the callbacks run by Flush may queue more right-hand sides)
+    while( !requests_.empty() && numQueued_+width > panelWidth_ )
+        Flush();
+
+    if( width == 0 )
+    {
+        // There is nothing to solve, but the notifications are kept in the
+        // order of submission
+        if( requests_.empty() )
+            Deliver( request );
+        else
+        {
+            request.offset = numQueued_;
+            requests_.push_back( std::move(request) );
+        }
+        return;
+    }
+
+    if( width > panelWidth_ )
+    {
+        try 
+        { 
+            internal::NodalSolve
+            ( inverseMap_, info_, L_, X, nodal1d_, nodal2d_ ); 
+        }
+        catch( ... )
+        {
+            if( request.hasPromise )
+                request.promise.set_exception( std::current_exception() );
+            throw;
+        }
+        ++numPanelsSolved_;
+        Deliver( request );
+        return;
+    }
+
+    if( !mpi::Congruent( X.Comm(), panel_.Comm() ) )
+        panel_.SetComm( X.Comm() );
+    if( panel_.Height() != X.Height() || panel_.Width() != panelWidth_ )
+        panel_.Resize( X.Height(), panelWidth_ );
+    CopyColumns( X, 0, panel_, numQueued_, width );
+    request.offset = numQueued_;
+    numQueued_ += width;
+    requests_.push_back( std::move(request) );
+    if( numQueued_ == panelWidth_ )
+        Flush();
+}
+
+template<typename F>
+inline void
+SolveSession<F>::Deliver( Request& request )
+{
+    if( request.hasPromise )
+        request.promise.set_value();
+    else if( request.callback )
+        request.callback( *request.X );
+}
+
+template<typename F>
+inline void
+SolveSession<F>::CopyColumns
+( const DistMultiVec<F>& A, int jA, DistMultiVec<F>& B, int jB, int width )
+{
+    const int localHeight = A.LocalHeight();
+    if( localHeight == 0 )
+        return;
+    const Matrix<F>& ALoc = A.LockedLocalMatrix();
+    Matrix<F>& BLoc = B.LocalMatrix();
+    const F* ABuf = ALoc.LockedBuffer();
+    F* BBuf = BLoc.Buffer();
+    const int ALDim = ALoc.LDim();
+    const int BLDim = BLoc.LDim();
+    for( int j=0; j<width; ++j )
+        std::copy
+        ( &ABuf[(jA+j)*ALDim], &ABuf[(jA+j)*ALDim]+localHeight, 
+          &BBuf[(jB+j)*BLDim] );
+}
+
+} // namespace cliq
+
+#endif // ifndef CLIQ_NUMERIC_SOLVESESSION_IMPL_HPP
@@ -0,0 +1,91 @@
+/*
+   Copyright (c) 2009-2014, Jack Poulson, Lexing Ying,
+   The University of Texas at Austin, Stanford University, and the
+   Georgia Insitute of Technology.
+   All rights reserved.
+ 
+   This file is part of Clique and is under the BSD 2-Clause License, 
+   which can be found in the LICENSE file in the root directory, or at 
+   http://opensource.org/licenses/BSD-2-Clause
+*/
+#pragma once
+#ifndef CLIQ_NUMERIC_SUBTREEMASK_HPP
+#define CLIQ_NUMERIC_SUBTREEMASK_HPP
+
+namespace cliq {
+
+// Flags for the nodes of this process's portion of the elimination tree which
+// mark whether the subtree rooted at each node is involved in a pruned solve.
+// The distributed flags are indexed as in DistSymmInfo::distNodes (so that 
+// distNodes[0] repeats the flag of the top local node), and the flag of each
+// distributed node is the same on every process in its team.
+struct SubtreeMask
+{
+    std::vector<bool> localNodes, distNodes;
+};
+
+// Mark each subtree which contains a nonzero entry of X. This requires one
+// (integer) reduction over the team of each distributed node.
+template<typename F>
+void MarkNonzeroSubtrees
+( const DistSymmInfo& info, const DistNodalMultiVec<F>& X, SubtreeMask& mask );
+
+//----------------------------------------------------------------------------//
+// Implementation begins here                                                 //
+//----------------------------------------------------------------------------//
+
+template<typename F>
+inline bool
+AnyNonzero( const Matrix<F>& A )
+{
+    const int height = A.Height();
+    const int width = A.Width();
+    const F* ABuf = A.LockedBuffer();
+    const int ALDim = A.LDim();
+    for( int j=0; j<width; ++j )
+        for( int i=0; i<height; ++i )
+            if( ABuf[i+j*ALDim] != F(0) )
+                return true;
+    return false;
+}
+
+template<typename F>
+inline void
+MarkNonzeroSubtrees
+( const DistSymmInfo& info, const DistNodalMultiVec<F>& X, SubtreeMask& mask )
+{
+    DEBUG_ONLY(CallStackEntry cse("MarkNonzeroSubtrees"))
+    const int numLocalNodes = info.localNodes.size();
+    const int numDistNodes = info.distNodes.size();
+    mask.localNodes.resize( numLocalNodes );
+    mask.distNodes.resize( numDistNodes );
+
+    // Since the local nodes are stored in a postordering, each child is 
+    // visited before its parent
+    for( int s=0; s<numLocalNodes; ++s )
+    {
+        const SymmNodeInfo& node = info.localNodes[s];
+        bool nonzero = false;
+        const int numChildren = node.children.size();
+        for( int c=0; c<numChildren; ++c )
+            nonzero = nonzero || mask.localNodes[node.children[c]];
+        mask.localNodes[s] = nonzero || AnyNonzero( X.localNodes[s] );
+    }
+    if( numDistNodes > 0 )
+        mask.distNodes[0] = mask.localNodes.back();
+
+    // The team of each distributed node is the union of the teams of its
+    // two children, so a single reduction combines both subtrees
+    for( int s=1; s<numDistNodes; ++s )
+    {
+        const bool nonzero = mask.distNodes[s-1] || 
+                             AnyNonzero( X.distNodes[s-1].LockedMatrix() );
+        mpi::Comm comm = info.distNodes[s].comm;
+        mask.distNodes[s] = 
+            ( mpi::AllReduce( int(nonzero), mpi::MAX, comm ) != 0 );
+    }
+}
+
+} // namespace cliq
+
+#endif // ifndef CLIQ_NUMERIC_SUBTREEMASK_HPP
@@ -0,0 +1,70 @@
+/*
+   Copyright (c) 2009-2014, Jack Poulson, Lexing Ying,
+   The University of Texas at Austin, Stanford University, and the
+   Georgia Insitute of Technology.
+   All rights reserved.
+ 
+   This file is part of Clique and is under the BSD 2-Clause License, 
+   which can be found in the LICENSE file in the root directory, or at 
+   http://opensource.org/licenses/BSD-2-Clause
+*/
+#pragma once
+#ifndef CLIQ_NUMERIC_UPDATEARENA_DECL_HPP
+#define CLIQ_NUMERIC_UPDATEARENA_DECL_HPP
+
+namespace cliq {
+
+// A single buffer which holds the update matrices of the local fronts during
+// the (sequential) factorization, managed as a stack. Each front's update 
+// matrix is pushed above the updates of its children, which it consumes, and,
+// once the front has been factored, it is moved down onto the position of its
+// children's updates. 
+//
+// Since the size of the stack depends upon the order in which the children of
+// each node are visited, the local nodes are traversed in a postordering which
+// visits the children in decreasing order of the difference between the peak
+// stack size of their subtree and the size of their update (Liu's ordering),
+// which minimizes the peak over all postorderings.
+//
+// Each offset is measured in entries.
+template<typename F>
+class UpdateArena
+{
+public:
+    UpdateArena();
+
+    // Lay out the local tree of 'info' and ensure that the buffer can hold the
+    // peak of the stack (the buffer only grows until Free is called)
+    void Reserve( const DistSymmInfo& info );
+    // Release the buffer (the layout is kept so that the peak may be queried)
+    void Free();
+    // Release the buffer and the layout, so that the peaks are zero (e.g., 
+    // since a threaded factorization does not use the stack)
+    void Clear();
+
+    // The number of entries in the buffer
+    std::size_t Capacity() const;
+    // The number of entries needed by the stack for the chosen traversal, and
+    // the number which would be needed by visiting the children in the order
+    // in which they are stored
+    std::size_t PeakEntries() const;
+    std::size_t PostorderPeakEntries() const;
+
+    // The order in which the local nodes should be factored
+    const std::vector<int>& Traversal() const;
+
+    std::size_t FrontOffset( int s ) const;
+    std::size_t UpdateOffset( int s ) const;
+
+    F* Buffer( std::size_t offset );
+
+private:
+    std::size_t peakEntries_, postorderPeakEntries_;
+    std::vector<int> traversal_;
+    std::vector<std::size_t> frontOffs_, updateOffs_;
+    std::vector<F> buffer_;
+};
+
+} // namespace cliq
+
+#endif // ifndef CLIQ_NUMERIC_UPDATEARENA_DECL_HPP
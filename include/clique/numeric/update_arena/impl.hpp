@@ -0,0 +1,189 @@
+/*
+   Copyright (c) 2009-2014, Jack Poulson, Lexing Ying,
+   The University of Texas at Austin, Stanford University, and the
+   Georgia Insitute of Technology.
+   All rights reserved.
+ 
+   This file is part of Clique and is under the BSD 2-Clause License, 
+   which can be found in the LICENSE file in the root directory, or at 
+   http://opensource.org/licenses/BSD-2-Clause
+*/
+#pragma once
+#ifndef CLIQ_NUMERIC_UPDATEARENA_IMPL_HPP
+#define CLIQ_NUMERIC_UPDATEARENA_IMPL_HPP
+
+namespace cliq {
+
+template<typename F>
+inline
+UpdateArena<F>::UpdateArena()
+: peakEntries_(0), postorderPeakEntries_(0)
+{ }
+
+template<typename F>
+inline void
+UpdateArena<F>::Reserve( const DistSymmInfo& info )
+{
+    DEBUG_ONLY(CallStackEntry cse("UpdateArena::Reserve"))
+    const int numLocalNodes = info.localNodes.size();
+
+    // Compute the peak stack size of each subtree, both for the stored order
+    // of the children and for visiting the child whose peak exceeds the size
+    // of its update by the most first. Since the local nodes are stored in a 
+    // postordering, each child is visited before its parent.
+    std::vector<std::size_t> updateEntries(numLocalNodes), 
+                             subtreePeaks(numLocalNodes),
+                             postorderPeaks(numLocalNodes);
+    std::vector<int> firstChildren(numLocalNodes,-1);
+    for( int s=0; s<numLocalNodes; ++s )
+    {
+        const SymmNodeInfo& node = info.localNodes[s];
+        const std::size_t updateSize = node.lowerStruct.size();
+        updateEntries[s] = updateSize*updateSize;
+        if( node.children.size() == 2 )
+        {
+            int first = node.children[0];
+            int second = node.children[1];
+            const std::size_t childEntries = 
+                updateEntries[first] + updateEntries[second];
+            postorderPeaks[s] = 
+                std::max
+                ( std::max
+                  ( postorderPeaks[first], 
+                    updateEntries[first]+postorderPeaks[second] ),
+                  childEntries+updateEntries[s] );
+
+            // The peak of a subtree is never less than the size of its update
+            if( subtreePeaks[second]-updateEntries[second] > 
+                subtreePeaks[first]-updateEntries[first] )
+                std::swap( first, second );
+            firstChildren[s] = first;
+            subtreePeaks[s] = 
+                std::max
+                ( std::max
+                  ( subtreePeaks[first], 
+                    updateEntries[first]+subtreePeaks[second] ),
+                  childEntries+updateEntries[s] );
+        }
+        else
+            subtreePeaks[s] = postorderPeaks[s] = updateEntries[s];
+    }
+
+    // Form the traversal by reversing a preordering which visits the first 
+    // child of each node last
+    traversal_.clear();
+    traversal_.reserve( numLocalNodes );
+    std::vector<int> stack;
+    if( numLocalNodes > 0 )
+        stack.push_back( numLocalNodes-1 );
+    while( !stack.empty() )
+    {
+        const int s = stack.back();
+        stack.pop_back();
+        traversal_.push_back( s );
+        const SymmNodeInfo& node = info.localNodes[s];
+        if( node.children.size() == 2 )
+        {
+            const int first = firstChildren[s];
+            const int second = 
+                ( first == node.children[0] ? node.children[1] 
+                                            : node.children[0] );
+            stack.push_back( first );
+            stack.push_back( second );
+        }
+    }
+    std::reverse( traversal_.begin(), traversal_.end() );
+
+    // Simulate the factorization
+    frontOffs_.resize( numLocalNodes );
+    updateOffs_.resize( numLocalNodes );
+    peakEntries_ = 0;
+    std::size_t top = 0;
+    for( int k=0; k<numLocalNodes; ++k )
+    {
+        const int s = traversal_[k];
+        std::size_t base = top;
+        if( firstChildren[s] != -1 )
+        {
+            const int first = firstChildren[s];
+            base = updateOffs_[first];
+            DEBUG_ONLY(
+                const SymmNodeInfo& node = info.localNodes[s];
+                const int second = 
+                    ( first == node.children[0] ? node.children[1] 
+                                                : node.children[0] );
+                if( updateOffs_[second] != base+updateEntries[first] ||
+                    top != updateOffs_[second]+updateEntries[second] )
+                    LogicError("Child updates were not on top of the stack");
+            )
+        }
+        frontOffs_[s] = top;
+        peakEntries_ = std::max( peakEntries_, top+updateEntries[s] );
+        updateOffs_[s] = base;
+        top = base + updateEntries[s];
+    }
+    DEBUG_ONLY(
+        if( numLocalNodes > 0 && peakEntries_ != subtreePeaks.back() )
+            LogicError("Simulated peak did not match the predicted peak");
+    )
+    postorderPeakEntries_ = 
+        ( numLocalNodes > 0 ? postorderPeaks.back() : 0 );
+
+    if( buffer_.size() < peakEntries_ )
+        buffer_.resize( peakEntries_ );
+}
+
+template<typename F>
+inline void
+UpdateArena<F>::Free()
+{ SwapClear( buffer_ ); }
+
+template<typename F>
+inline void
+UpdateArena<F>::Clear()
+{
+    peakEntries_ = postorderPeakEntries_ = 0;
+    SwapClear( traversal_ );
+    SwapClear( frontOffs_ );
+    SwapClear( updateOffs_ );
+    SwapClear( buffer_ );
+}
+
+template<typename F>
+inline std::size_t
+UpdateArena<F>::Capacity() const
+{ return buffer_.size(); }
+
+template<typename F>
+inline std::size_t
+UpdateArena<F>::PeakEntries() const
+{ return peakEntries_; }
+
+template<typename F>
+inline std::size_t
+UpdateArena<F>::PostorderPeakEntries() const
+{ return postorderPeakEntries_; }
+
+template<typename F>
+inline const std::vector<int>&
+UpdateArena<F>::Traversal() const
+{ return traversal_; }
+
+template<typename F>
+inline std::size_t
+UpdateArena<F>::FrontOffset( int s ) const
+{ return frontOffs_[s]; }
+
+template<typename F>
+inline std::size_t
+UpdateArena<F>::UpdateOffset( int s ) const
+{ return updateOffs_[s]; }
+
+template<typename F>
+inline F*
+UpdateArena<F>::Buffer( std::size_t offset )
+{ return buffer_.data() + offset; }
+
+} // namespace cliq
+
+#endif // ifndef CLIQ_NUMERIC_UPDATEARENA_IMPL_HPP
@@ -0,0 +1,203 @@
+/*
+   Copyright (c) 2009-2014, Jack Poulson, Lexing Ying,
+   The University of Texas at Austin, Stanford University, and the
+   Georgia Insitute of Technology.
+   All rights reserved.
+ 
+   This file is part of Clique and is under the BSD 2-Clause License, 
+   which can be found in the LICENSE file in the root directory, or at 
+   http://opensource.org/licenses/BSD-2-Clause
+*/
+#pragma once
+#ifndef CLIQ_SYMBOLIC_AMALGAMATE_HPP
+#define CLIQ_SYMBOLIC_AMALGAMATE_HPP
+
+namespace cliq {
+
+// Relaxed supernode amalgamation of the local portion of the elimination
+// tree: a node whose two children are both leaves is merged with them into a
+// single (dense) leaf front whenever the fraction of explicit zeros in the
+// merged front is at most 'maxZeroRatio' and the total number of explicit
+// zeros introduced on this process stays below 'maxMemoryGrowth' times the
+// number of entries of the unamalgamated local factor. Since merged nodes
+// become leaves, whole subtrees of small separators can be collapsed.
+// If amalgamation is disabled (maxZeroRatio <= 0), then the trees are left
+// untouched and the statistics in 'amalgInfo' are all zero.
+//
+// This must be called after ReverseOrder and before BuildMap.
+void Amalgamate
+( DistSeparatorTree& sepTree, DistSymmElimTree& eTree,
+  AmalgamationInfo& amalgInfo,
+  double maxZeroRatio, double maxMemoryGrowth=0.1 );
+
+//----------------------------------------------------------------------------//
+// Implementation begins here                                                 //
+//----------------------------------------------------------------------------//
+
+// The number of entries in the lower trapezoid of a front with 'size' pivots
+// and 'lowerSize' rows in its lower structure
+inline double
+FrontFactorEntries( double size, double lowerSize )
+{ return size*(size+1)/2 + size*lowerSize; }
+
+inline void
+Amalgamate
+( DistSeparatorTree& sepTree, DistSymmElimTree& eTree,
+  AmalgamationInfo& amalgInfo, double maxZeroRatio, double maxMemoryGrowth )
+{
+    DEBUG_ONLY(CallStackEntry cse("Amalgamate"))
+    const int numNodes = eTree.localNodes.size();
+    DEBUG_ONLY(
+        if( (int)sepTree.localSepsAndLeaves.size() != numNodes )
+            LogicError("Separator and elimination trees do not match");
+    )
+    amalgInfo.numMerged = 0;
+    amalgInfo.origEntries = 0;
+    amalgInfo.extraEntries = 0;
+    if( maxZeroRatio <= 0 )
+        return;
+
+    // Perform the structural part of the local symbolic factorization (see
+    // MergeStructs) in order to find the size of each front
+    std::vector<std::vector<int>> structs( numNodes );
+    std::vector<int> lowerSizes( numNodes );
+    std::vector<int> leftRelInds, rightRelInds, origRelInds, scratch;
+    for( int s=0; s<numNodes; ++s )
+    {
+        const SymmNode& node = *eTree.localNodes[s];
+        const int numChildren = node.children.size();
+        if( numChildren == 2 )
+            MergeStructs
+            ( node.off, node.size, 
+              structs[node.children[0]], structs[node.children[1]], 
+              node.lowerStruct, structs[s], 
+              leftRelInds, rightRelInds, origRelInds, scratch );
+        else
+            structs[s] = node.lowerStruct;
+        lowerSizes[s] = structs[s].size();
+        amalgInfo.origEntries += FrontFactorEntries( node.size, lowerSizes[s] );
+    }
+    if( numNodes == 1 )
+        return;
+    const double maxExtraEntries = maxMemoryGrowth*amalgInfo.origEntries;
+
+    // Visit the nodes in their post-ordering so that merged nodes are leaves
+    // by the time that their parents are visited. For each node, we track
+    // the entries of the unamalgamated factor within it and its current
+    // number of entries.
+    std::vector<double> origEntries( numNodes ), entries( numNodes );
+    std::vector<bool> merged( numNodes, false );
+    for( int s=0; s<numNodes; ++s )
+    {
+        SymmNode& node = *eTree.localNodes[s];
+        const double ownEntries = 
+            FrontFactorEntries( node.size, lowerSizes[s] );
+        origEntries[s] = entries[s] = ownEntries;
+        if( node.children.size() != 2 )
+            continue;
+        int left = node.children[0];
+        int right = node.children[1];
+        const SymmNode& leftNode = *eTree.localNodes[left];
+        const SymmNode& rightNode = *eTree.localNodes[right];
+        if( leftNode.children.size() != 0 || rightNode.children.size() != 0 )
+            continue;
+        if( leftNode.off > rightNode.off )
+            std::swap( left, right );
+        const SymmNode& first = *eTree.localNodes[left];
+        const SymmNode& second = *eTree.localNodes[right];
+        // The two leaves and the separator must be contiguous in the ordering
+        if( first.off+first.size != second.off ||
+            second.off+second.size != node.off )
+            continue;
+
+        // The merged front has the same lower structure as the separator
+        const int mergedSize = first.size + second.size + node.size;
+        const double mergedEntries =
+            FrontFactorEntries( mergedSize, lowerSizes[s] );
+        const double subtreeEntries =
+            origEntries[left] + origEntries[right] + ownEntries;
+        const double currentEntries =
+            entries[left] + entries[right] + ownEntries;
+        const double zeros = mergedEntries - subtreeEntries;
+        const double addedEntries = mergedEntries - currentEntries;
+        if( zeros > maxZeroRatio*mergedEntries ||
+            amalgInfo.extraEntries+addedEntries > maxExtraEntries )
+        {
+            origEntries[s] = subtreeEntries;
+            entries[s] = currentEntries;
+            continue;
+        }
+
+        // Absorb both leaves into this node
+        SepOrLeaf& sep = *sepTree.localSepsAndLeaves[s];
+        const SepOrLeaf& firstLeaf = *sepTree.localSepsAndLeaves[left];
+        const SepOrLeaf& secondLeaf = *sepTree.localSepsAndLeaves[right];
+        std::vector<int> inds;
+        inds.reserve( mergedSize );
+        inds.insert( inds.end(), firstLeaf.inds.begin(), firstLeaf.inds.end() );
+        inds.insert
+        ( inds.end(), secondLeaf.inds.begin(), secondLeaf.inds.end() );
+        inds.insert( inds.end(), sep.inds.begin(), sep.inds.end() );
+        sep.inds.swap( inds );
+        sep.off = firstLeaf.off;
+
+        node.off = first.off;
+        node.size = mergedSize;
+        node.lowerStruct = structs[s];
+        SwapClear( node.children );
+        merged[left] = merged[right] = true;
+        origEntries[s] = subtreeEntries;
+        entries[s] = mergedEntries;
+        amalgInfo.extraEntries += addedEntries;
+        amalgInfo.numMerged += 2;
+    }
+    if( amalgInfo.numMerged == 0 )
+        return;
+
+    // The bottom distributed node is the local root
+    if( eTree.distNodes.size() != 0 )
+    {
+        const SymmNode& root = *eTree.localNodes[numNodes-1];
+        DistSymmNode& distNode = eTree.distNodes[0];
+        distNode.size = root.size;
+        distNode.off = root.off;
+        distNode.lowerStruct = root.lowerStruct;
+    }
+
+    // Remove the absorbed nodes while preserving the post-ordering
+    std::vector<int> newInds( numNodes, -1 );
+    int numKept = 0;
+    for( int s=0; s<numNodes; ++s )
+    {
+        if( merged[s] )
+        {
+            delete eTree.localNodes[s];
+            delete sepTree.localSepsAndLeaves[s];
+        }
+        else
+        {
+            newInds[s] = numKept;
+            eTree.localNodes[numKept] = eTree.localNodes[s];
+            sepTree.localSepsAndLeaves[numKept] = sepTree.localSepsAndLeaves[s];
+            ++numKept;
+        }
+    }
+    eTree.localNodes.resize( numKept );
+    sepTree.localSepsAndLeaves.resize( numKept );
+    for( int s=0; s<numKept; ++s )
+    {
+        SymmNode& node = *eTree.localNodes[s];
+        SepOrLeaf& sepOrLeaf = *sepTree.localSepsAndLeaves[s];
+        if( node.parent != -1 )
+            node.parent = newInds[node.parent];
+        if( sepOrLeaf.parent != -1 )
+            sepOrLeaf.parent = newInds[sepOrLeaf.parent];
+        const int numChildren = node.children.size();
+        for( int c=0; c<numChildren; ++c )
+            node.children[c] = newInds[node.children[c]];
+    }
+}
+
+} // namespace cliq
+
+#endif // ifndef CLIQ_SYMBOLIC_AMALGAMATE_HPP
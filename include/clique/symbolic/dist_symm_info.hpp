@@ -33,6 +33,9 @@ struct SymmNodeInfo
     std::vector<int> origLowerRelInds;
     // (maps from the child update indices to our frontal indices).
     std::vector<int> leftRelInds, rightRelInds;
+    // The maximal runs of consecutive relative indices (see ContiguousRuns),
+    // which the extend-adds of the factorization and solves are blocked over
+    std::vector<int> leftRunStarts, rightRunStarts;
 };
 
 struct FactorCommMeta
@@ -42,13 +45,27 @@ struct FactorCommMeta
     // computed from the above information (albeit somewhat expensively).
     mutable std::vector<std::vector<int>> childRecvInds;
 
+    // Persistent plans for exchanging the child update matrices, which are
+    // built during the first factorization and then reused. The pipelined 
+    // factorization splits each message at the boundary of the leading block
+    // of the front.
+    mutable CommPlan childUpdatePlan, childLeadPlan, childTrailPlan;
+
     void EmptyChildRecvIndices() const
     { SwapClear(childRecvInds); }
 
+    void EmptyPlans() const
+    {
+        childUpdatePlan.Empty();
+        childLeadPlan.Empty();
+        childTrailPlan.Empty();
+    }
+
     void Empty()
     {
         SwapClear( numChildSendInds );
         EmptyChildRecvIndices();
+        EmptyPlans();
     }
 };
 
@@ -58,10 +75,17 @@ struct MultiVecCommMeta
     std::vector<int> numChildSendInds;
     std::vector<std::vector<int>> childRecvInds;
 
+    // Persistent plans for the forward (child to parent) and backward 
+    // (parent to child) exchanges of the solves, where each row of the 
+    // right-hand sides is sent as a single block
+    mutable CommPlan forwardPlan, backwardPlan;
+
     void Empty()
     {
         SwapClear( numChildSendInds );
         SwapClear( childRecvInds );
+        forwardPlan.Empty();
+        backwardPlan.Empty();
     }
 };
 
@@ -70,10 +94,15 @@ struct MatrixCommMeta
     std::vector<int> numChildSendInds;
     std::vector<std::vector<int>> childRecvInds;
 
+    // Persistent plans for the forward and backward exchanges of the solves
+    mutable CommPlan forwardPlan, backwardPlan;
+
     void Empty()
     {
         SwapClear( numChildSendInds );
         SwapClear( childRecvInds );
+        forwardPlan.Empty();
+        backwardPlan.Empty();
     }
 };
 
@@ -105,11 +134,83 @@ struct DistSymmNodeInfo
     MultiVecCommMeta multiVecMeta;
 };
 
+// The pattern for redistributing a DistMultiVec between the original ordering
+// and the nodal distribution (see DistNodalMultiVec::Pull and Push). It is
+// built during the first redistribution and reused for as long as the 
+// inverse map is unmodified (see DistMap::Version) and the same height is 
+// used. The exchanges are performed over the communicator of the root node,
+// so that the plans are released along with the analysis.
+struct NodalRedistMeta
+{
+    std::size_t mapVersion;
+    int height;
+    // The number of rows sent from each owner to each nodal process
+    std::vector<int> ownedCounts, nodalCounts;
+    // The local row of X for each entry which we own and another process
+    // needs, packed in the order of the owner's buffer
+    std::vector<int> ownedRows;
+    // The position in the nodal side's buffer of each of our nodal rows, 
+    // in the order they are traversed in the elimination tree
+    std::vector<int> nodalOffs;
+
+    // The pull plan sends from the owners to the nodal distribution, and the
+    // push plan performs the reverse exchange
+    mutable CommPlan pullPlan, pushPlan;
+
+    NodalRedistMeta() : mapVersion(0), height(-1) { }
+
+    // The versions of the maps are process-local, but, since every process
+    // takes part in each modification of a DistMap, the processes of 'comm' 
+    // agree on whether or not the map was modified
+    bool Matches( const DistMap& map, int mapHeight, mpi::Comm comm ) const
+    { 
+        const bool matches = 
+            ( mapVersion == map.Version() && height == mapHeight );
+        DEBUG_ONLY(
+            const int numMatches = mpi::AllReduce( int(matches), comm );
+            if( numMatches != 0 && numMatches != mpi::Size(comm) )
+                LogicError("Inverse map was only modified on some processes");
+        )
+        return matches;
+    }
+
+    void Empty()
+    {
+        mapVersion = 0;
+        height = -1;
+        SwapClear( ownedCounts );
+        SwapClear( nodalCounts );
+        SwapClear( ownedRows );
+        SwapClear( nodalOffs );
+        pullPlan.Empty();
+        pushPlan.Empty();
+    }
+};
+
+// Statistics from the relaxed amalgamation of the local elimination tree 
+// (see Amalgamate)
+struct AmalgamationInfo
+{
+    // The number of local nodes which were absorbed into their parents
+    int numMerged;
+    // The number of entries in the lower trapezoids of the local fronts 
+    // before amalgamation and the number of explicit zeros it introduced
+    double origEntries, extraEntries;
+
+    AmalgamationInfo() : numMerged(0), origEntries(0), extraEntries(0) { }
+};
+
 struct DistSymmInfo
 {
     std::vector<SymmNodeInfo> localNodes;
     std::vector<DistSymmNodeInfo> distNodes;
+    mutable NodalRedistMeta redistMeta;
+    AmalgamationInfo amalgamation;
     ~DistSymmInfo();
+
+    // Free the distributed nodes, including their process grids and 
+    // communicators, and the communication plans built over them
+    void EmptyDistNodes();
 };
 
 // Utilities
@@ -125,13 +226,24 @@ void GetChildGridDims
 
 inline
 DistSymmInfo::~DistSymmInfo()
+{ EmptyDistNodes(); }
+
+inline void
+DistSymmInfo::EmptyDistNodes()
 {
+    // The persistent requests of the plans must be freed before the 
+    // communicators which they were created over, as otherwise a plan could 
+    // be mistaken as ready for a new communicator which reuses the handle
+    redistMeta.Empty();
     const int numDist = distNodes.size();
     for( int s=0; s<numDist; ++s )
     {
+        distNodes[s].factorMeta.Empty();
+        distNodes[s].multiVecMeta.Empty();
         delete distNodes[s].grid;
         mpi::Free( distNodes[s].comm );
     }
+    SwapClear( distNodes );
 }
 
 } // namespace cliq
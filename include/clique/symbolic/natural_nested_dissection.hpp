@@ -23,7 +23,10 @@ void NaturalNestedDissection
         DistSeparatorTree& sepTree, 
         DistSymmInfo& info,
         int cutoff=128, 
-        bool storeFactRecvInds=false );
+        bool storeFactRecvInds=false,
+        double maxZeroRatio=0, 
+        double maxMemoryGrowth=0.1,
+        bool threaded=false );
 
 int NaturalBisect
 (       int nx, 
@@ -454,7 +457,10 @@ NaturalNestedDissection
         DistSeparatorTree& sepTree, 
         DistSymmInfo& info,
         int cutoff, 
-        bool storeFactRecvInds )
+        bool storeFactRecvInds,
+        double maxZeroRatio,
+        double maxMemoryGrowth,
+        bool threaded )
 {
     DEBUG_ONLY(CallStackEntry cse("NaturalNestedDissection"))
     // NOTE: There is a potential memory leak here if these data structures 
@@ -478,13 +484,15 @@ NaturalNestedDissection
     ( nx, ny, nz, graph, perm, sepTree, eTree, 0, 0, false, cutoff );
 
     ReverseOrder( sepTree, eTree );
+    Amalgamate
+    ( sepTree, eTree, info.amalgamation, maxZeroRatio, maxMemoryGrowth );
 
     // Construct the distributed reordering    
     BuildMap( graph, sepTree, map );
     DEBUG_ONLY(EnsurePermutation( map ))
 
     // Run the symbolic analysis
-    SymmetricAnalysis( eTree, info, storeFactRecvInds );
+    SymmetricAnalysis( eTree, info, storeFactRecvInds, threaded );
 }
 
 inline int 
@@ -26,6 +26,9 @@ void CliqParallelBisect
   idx_t* nparseps, idx_t* nseqseps, real_t* imbalance, idx_t* options, 
   idx_t* perm, idx_t* sizes, MPI_Comm* comm );
 
+int CliqMinimumDegree
+( idx_t* nvtxs, idx_t* xAdj, idx_t* adjacency, idx_t* order );
+
 } // extern "C"
 #endif 
 
@@ -41,7 +44,11 @@ void NestedDissection
         int numDistSeps=1, 
         int numSeqSeps=1, 
         int cutoff=128, 
-        bool storeFactRecvInds=false );
+        bool storeFactRecvInds=false,
+        double maxZeroRatio=0, 
+        double maxMemoryGrowth=0.1,
+        bool orderLeaves=false,
+        bool threaded=false );
 
 int Bisect
 ( const Graph& graph, 
@@ -59,6 +66,11 @@ int Bisect
         bool sequential=true,
         int numDistSeps=1, 
         int numSeqSeps=1 );
+
+// Computes a multiple minimum degree ordering of the vertices of a graph 
+// (ignoring any connections to vertices outside of it), where vertex 's' is 
+// mapped to position 'perm[s]'
+void MinimumDegree( const Graph& graph, std::vector<int>& perm );
 #endif // HAVE_PARMETIS
 
 int DistributedDepth( mpi::Comm comm );
@@ -112,6 +124,302 @@ DistributedDepth( mpi::Comm comm )
 }
 
 #ifdef HAVE_PARMETIS
+// Replace a leaf of nested dissection with the supernodal elimination tree
+// of its minimum degree ordering. The local tree must be binary, so each 
+// supernode with a single child is given an empty leaf as a second child, 
+// and the children of a supernode with more than two children are combined 
+// pairwise through empty nodes (whose fronts only hold the sum of the 
+// updates of their children).
+inline void
+BuildLeafSubtree
+( const Graph& graph,
+  const std::vector<int>& perm,
+        DistSeparatorTree& sepTree,
+        DistSymmElimTree& eTree,
+        int parent,
+        int off )
+{
+    DEBUG_ONLY(CallStackEntry cse("BuildLeafSubtree"))
+    const int numSources = graph.NumSources();
+    std::vector<int> mdPerm;
+    MinimumDegree( graph, mdPerm );
+    std::vector<int> mdInvPerm( numSources );
+    for( int s=0; s<numSources; ++s )
+        mdInvPerm[mdPerm[s]] = s;
+
+    // Form the elimination forest of the reordered leaf using path 
+    // compression (see Liu's "The role of elimination trees in sparse
+    // factorization")
+    std::vector<int> etreeParents( numSources, -1 ), ancestors( numSources );
+    for( int k=0; k<numSources; ++k )
+    {
+        ancestors[k] = -1;
+        const int source = mdInvPerm[k];
+        const int numConnections = graph.NumConnections( source );
+        const int edgeOff = graph.EdgeOffset( source );
+        for( int t=0; t<numConnections; ++t )
+        {
+            const int target = graph.Target( edgeOff+t );
+            if( target >= numSources )
+                continue;
+            int i = mdPerm[target];
+            if( i >= k )
+                continue;
+            while( ancestors[i] != -1 && ancestors[i] != k )
+            {
+                const int next = ancestors[i];
+                ancestors[i] = k;
+                i = next;
+            }
+            if( ancestors[i] == -1 )
+            {
+                ancestors[i] = k;
+                etreeParents[i] = k;
+            }
+        }
+    }
+
+    // Postorder the forest so that each subtree is contiguous
+    std::vector<int> childOffs( numSources+3, 0 ), etreeChildren( numSources );
+    for( int k=0; k<numSources; ++k )
+        ++childOffs[( etreeParents[k] == -1 ? numSources : etreeParents[k] )+2];
+    for( int k=0; k<=numSources; ++k )
+        childOffs[k+2] += childOffs[k+1];
+    for( int k=0; k<numSources; ++k )
+    {
+        const int p = ( etreeParents[k] == -1 ? numSources : etreeParents[k] );
+        etreeChildren[childOffs[p+1]++] = k;
+    }
+    std::vector<int> postInvPerm;
+    postInvPerm.reserve( numSources );
+    {
+        std::vector<std::pair<int,int>> 
+            stack( 1, std::make_pair(numSources,0) );
+        while( !stack.empty() )
+        {
+            const int k = stack.back().first;
+            const int c = childOffs[k] + stack.back().second;
+            if( c < childOffs[k+1] )
+            {
+                ++stack.back().second;
+                stack.push_back( std::make_pair(etreeChildren[c],0) );
+            }
+            else
+            {
+                if( k != numSources )
+                    postInvPerm.push_back( mdInvPerm[k] );
+                stack.pop_back();
+            }
+        }
+    }
+    std::vector<int> postPerm( numSources ), postParents( numSources );
+    for( int k=0; k<numSources; ++k )
+        postPerm[postInvPerm[k]] = k;
+    for( int k=0; k<numSources; ++k )
+    {
+        const int mdParent = etreeParents[mdPerm[postInvPerm[k]]];
+        postParents[k] = 
+            ( mdParent == -1 ? -1 : postPerm[mdInvPerm[mdParent]] );
+    }
+
+    // Compute the structure of each column of the factor, in terms of the 
+    // indices of the full reordering, from the structures of its children
+    std::vector<std::vector<int>> colStructs( numSources );
+    std::vector<int> colCounts( numSources );
+    for( int k=0; k<numSources; ++k )
+    {
+        const int source = postInvPerm[k];
+        const int numConnections = graph.NumConnections( source );
+        const int edgeOff = graph.EdgeOffset( source );
+        std::vector<int> origStruct;
+        for( int t=0; t<numConnections; ++t )
+        {
+            const int target = graph.Target( edgeOff+t );
+            const int i = 
+                ( target < numSources ? off+postPerm[target] : off+target );
+            if( i > off+k )
+                origStruct.push_back( i );
+        }
+        std::sort( origStruct.begin(), origStruct.end() );
+        origStruct.erase
+        ( std::unique( origStruct.begin(), origStruct.end() ), 
+          origStruct.end() );
+        auto fullStruct = Union( origStruct, colStructs[k] );
+        SwapClear( colStructs[k] );
+        colCounts[k] = fullStruct.size();
+        if( postParents[k] != -1 )
+        {
+            // The parent is the first entry of the structure, and the rest
+            // is inherited by the parent (which is visited later)
+            const int p = postParents[k];
+            DEBUG_ONLY(
+                if( fullStruct[0] != off+p )
+                    LogicError("Parent was not first in column structure");
+            )
+            std::vector<int> childStruct
+            ( fullStruct.begin()+1, fullStruct.end() );
+            colStructs[p] = Union( colStructs[p], childStruct );
+        }
+    }
+
+    // Group the columns into fundamental supernodes: column k is appended to
+    // the supernode of column k-1 if it is the only child of column k and
+    // the structure of column k-1 is exactly column k and its structure
+    std::vector<int> numColChildren( numSources, 0 );
+    for( int k=0; k<numSources; ++k )
+        if( postParents[k] != -1 )
+            ++numColChildren[postParents[k]];
+    std::vector<int> superStarts, superOf( numSources );
+    for( int k=0; k<numSources; ++k )
+    {
+        if( k == 0 || postParents[k-1] != k || numColChildren[k] != 1 ||
+            colCounts[k-1] != colCounts[k]+1 )
+            superStarts.push_back( k );
+        superOf[k] = superStarts.size()-1;
+    }
+    const int numSupernodes = superStarts.size();
+    superStarts.push_back( numSources );
+
+    // The supernodal tree, where multiple roots are made the children of an
+    // empty root (with index numSupernodes)
+    std::vector<std::vector<int>> superChildren( numSupernodes+1 );
+    for( int S=0; S<numSupernodes; ++S )
+    {
+        const int lastParent = postParents[superStarts[S+1]-1];
+        const int superParent = 
+            ( lastParent == -1 ? numSupernodes : superOf[lastParent] );
+        superChildren[superParent].push_back( S );
+    }
+    const bool emptyRoot = ( superChildren[numSupernodes].size() > 1 );
+
+    // Form the binary tree, where each node owns the contiguous range of 
+    // postordered columns [pos,pos+size)
+    struct BinaryNode { int pos, size, left, right; };
+    std::vector<BinaryNode> binNodes;
+    std::vector<int> superBins( numSupernodes+1 );
+    const int numSuperVisits = ( emptyRoot ? numSupernodes+1 : numSupernodes );
+    for( int S=0; S<numSuperVisits; ++S )
+    {
+        const std::vector<int>& children = superChildren[S];
+        const int numChildren = children.size();
+        int left=-1, right=-1;
+        if( numChildren == 1 )
+        {
+            BinaryNode emptyLeaf = { superStarts[S], 0, -1, -1 };
+            left = superBins[children[0]];
+            right = binNodes.size();
+            binNodes.push_back( emptyLeaf );
+        }
+        else if( numChildren >= 2 )
+        {
+            left = superBins[children[0]];
+            for( int c=1; c<numChildren-1; ++c )
+            {
+                const int child = children[c];
+                BinaryNode emptyNode = 
+                    { superStarts[child+1], 0, left, superBins[child] };
+                left = binNodes.size();
+                binNodes.push_back( emptyNode );
+            }
+            right = superBins[children[numChildren-1]];
+        }
+        const int size = 
+            ( S == numSupernodes ? 0 : superStarts[S+1]-superStarts[S] );
+        BinaryNode node = { superStarts[S], size, left, right };
+        superBins[S] = binNodes.size();
+        binNodes.push_back( node );
+    }
+    const int root = 
+        superBins[ emptyRoot ? numSupernodes 
+                             : superChildren[numSupernodes][0] ];
+
+    // Postorder the binary tree (left before right) and then push the nodes
+    // in the reverse order, as is done by NestedDissectionRecursion
+    const int numBin = binNodes.size();
+    std::vector<int> binPost, binParents( numBin, -1 );
+    binPost.reserve( numBin );
+    {
+        std::vector<std::pair<int,int>> stack( 1, std::make_pair(root,0) );
+        while( !stack.empty() )
+        {
+            const BinaryNode& node = binNodes[stack.back().first];
+            const int c = stack.back().second++;
+            if( c < 2 && node.left != -1 )
+            {
+                const int child = ( c == 0 ? node.left : node.right );
+                binParents[child] = stack.back().first;
+                stack.push_back( std::make_pair(child,0) );
+            }
+            else
+            {
+                binPost.push_back( stack.back().first );
+                stack.pop_back();
+            }
+        }
+    }
+    DEBUG_ONLY(
+        if( (int)binPost.size() != numBin )
+            LogicError("Binary leaf tree was not connected");
+    )
+    const int base = eTree.localNodes.size();
+    std::vector<int> binInds( numBin );
+    for( int q=0; q<numBin; ++q )
+        binInds[binPost[q]] = base + (numBin-1-q);
+    for( int q=numBin-1; q>=0; --q )
+    {
+        const int b = binPost[q];
+        const BinaryNode& binNode = binNodes[b];
+        const int nodeParent = 
+            ( binParents[b] == -1 ? parent : binInds[binParents[b]] );
+
+        sepTree.localSepsAndLeaves.push_back( new SepOrLeaf );
+        SepOrLeaf& sepOrLeaf = *sepTree.localSepsAndLeaves.back();
+        sepOrLeaf.parent = nodeParent;
+        sepOrLeaf.off = off + binNode.pos;
+        sepOrLeaf.inds.resize( binNode.size );
+        for( int s=0; s<binNode.size; ++s )
+            sepOrLeaf.inds[s] = perm[postInvPerm[binNode.pos+s]];
+
+        eTree.localNodes.push_back( new SymmNode );
+        SymmNode& node = *eTree.localNodes.back();
+        node.size = binNode.size;
+        node.off = off + binNode.pos;
+        node.parent = nodeParent;
+        if( binNode.left == -1 )
+            SwapClear( node.children );
+        else
+        {
+            node.children.resize( 2 );
+            node.children[0] = binInds[binNode.left];
+            node.children[1] = binInds[binNode.right];
+        }
+        std::set<int> connectedAncestors;
+        for( int s=0; s<binNode.size; ++s )
+        {
+            const int source = postInvPerm[binNode.pos+s];
+            const int numConnections = graph.NumConnections( source );
+            const int edgeOff = graph.EdgeOffset( source );
+            for( int t=0; t<numConnections; ++t )
+            {
+                const int target = graph.Target( edgeOff+t );
+                const int i = 
+                    ( target < numSources ? off+postPerm[target] 
+                                          : off+target );
+                if( i >= node.off+node.size )
+                    connectedAncestors.insert( i );
+            }
+        }
+        node.lowerStruct.resize( connectedAncestors.size() );
+        std::copy
+        ( connectedAncestors.begin(), connectedAncestors.end(), 
+          node.lowerStruct.begin() );
+    }
+}
+
+// Sequential graphs with fewer than this many vertices are dissected by the
+// task which reaches them rather than being split into further tasks
+const int minNestedDissectionTaskSize = 10000;
+
 inline void
 NestedDissectionRecursion
 ( const Graph& graph, 
@@ -121,10 +429,106 @@ NestedDissectionRecursion
         int parent, 
         int off, 
         int numSeps=5,
-        int cutoff=128 )
+        int cutoff=128,
+        bool orderLeaves=false,
+        bool threaded=false );
+
+// Move the nodes of a local subtree, which was built separately with a root 
+// whose parent is -1, onto the end of the local trees and attach its root to
+// local node 'parent'
+inline void
+AppendLocalSubtree
+( DistSeparatorTree& subSepTree, DistSymmElimTree& subETree,
+  DistSeparatorTree& sepTree, DistSymmElimTree& eTree, int parent )
+{
+    DEBUG_ONLY(CallStackEntry cse("AppendLocalSubtree"))
+    const int base = eTree.localNodes.size();
+    const int numNodes = subETree.localNodes.size();
+    for( int s=0; s<numNodes; ++s )
+    {
+        SepOrLeaf* sepOrLeaf = subSepTree.localSepsAndLeaves[s];
+        SymmNode* node = subETree.localNodes[s];
+        sepOrLeaf->parent = 
+            ( sepOrLeaf->parent == -1 ? parent : sepOrLeaf->parent+base );
+        node->parent = ( node->parent == -1 ? parent : node->parent+base );
+        const int numChildren = node->children.size();
+        for( int c=0; c<numChildren; ++c )
+            node->children[c] += base;
+        sepTree.localSepsAndLeaves.push_back( sepOrLeaf );
+        eTree.localNodes.push_back( node );
+    }
+    // The local trees now own the nodes
+    SwapClear( subSepTree.localSepsAndLeaves );
+    SwapClear( subETree.localNodes );
+}
+
+// Recursively dissect the two children of local node 'parent' (which were
+// split off of the graph occupying [off,off+leftSize+rightSize)), pushing 
+// the right subtree before the left so that, once we later reverse the order
+// of the nodes, the left subtree will be ordered first.
+//
+// If 'threaded' is true, then the two subtrees are built concurrently into 
+// separate lists as OpenMP tasks and are then appended in the same order.
+inline void
+NestedDissectionChildren
+( const Graph& leftChild, const std::vector<int>& leftPerm,
+  const Graph& rightChild, const std::vector<int>& rightPerm,
+  DistSeparatorTree& sepTree, DistSymmElimTree& eTree,
+  int parent, int off, int numSeps, int cutoff, bool orderLeaves,
+  bool threaded )
+{
+    DEBUG_ONLY(CallStackEntry cse("NestedDissectionChildren"))
+    SymmNode& node = *eTree.localNodes[parent];
+    const int leftChildSize = leftChild.NumSources();
+#ifdef HAVE_OPENMP
+    if( threaded && 
+        leftChildSize+rightChild.NumSources() >= minNestedDissectionTaskSize )
+    {
+        DistSeparatorTree leftSepTree, rightSepTree;
+        DistSymmElimTree leftETree, rightETree;
+        #pragma omp task default(shared)
+        NestedDissectionRecursion
+        ( rightChild, rightPerm, rightSepTree, rightETree, -1, 
+          off+leftChildSize, numSeps, cutoff, orderLeaves, true );
+        NestedDissectionRecursion
+        ( leftChild, leftPerm, leftSepTree, leftETree, -1, off, 
+          numSeps, cutoff, orderLeaves, true );
+        #pragma omp taskwait
+
+        node.children[1] = eTree.localNodes.size();
+        AppendLocalSubtree( rightSepTree, rightETree, sepTree, eTree, parent );
+        node.children[0] = eTree.localNodes.size();
+        AppendLocalSubtree( leftSepTree, leftETree, sepTree, eTree, parent );
+        return;
+    }
+#endif // ifdef HAVE_OPENMP
+    node.children[1] = eTree.localNodes.size();
+    NestedDissectionRecursion
+    ( rightChild, rightPerm, sepTree, eTree, parent, off+leftChildSize,
+      numSeps, cutoff, orderLeaves, threaded );
+    node.children[0] = eTree.localNodes.size();
+    NestedDissectionRecursion
+    ( leftChild, leftPerm, sepTree, eTree, parent, off, 
+      numSeps, cutoff, orderLeaves, threaded );
+}
+
+inline void
+NestedDissectionRecursion
+( const Graph& graph, 
+  const std::vector<int>& perm,
+        DistSeparatorTree& sepTree, 
+        DistSymmElimTree& eTree,
+        int parent, 
+        int off, 
+        int numSeps,
+        int cutoff,
+        bool orderLeaves,
+        bool threaded )
 {
     DEBUG_ONLY(CallStackEntry cse("NestedDissectionRecursion"))
-    if( graph.NumSources() <= cutoff )
+    if( orderLeaves && graph.NumSources() <= cutoff && graph.NumSources() > 1 )
+        BuildLeafSubtree( graph, perm, sepTree, eTree, parent, off );
+    else if( graph.NumSources() <= cutoff )
     {
         // Fill in this node of the local separator tree
         const int numSources = graph.NumSources();
@@ -223,17 +627,10 @@ NestedDissectionRecursion
         for( int s=0; s<rightChildSize; ++s )
             rightPerm[s] = perm[inverseMap[s+leftChildSize]];
 
-        // Update right then left so that, once we later reverse the order 
-        // of the nodes, the left node will be ordered first
         const int parent = eTree.localNodes.size()-1;
-        node.children[1] = eTree.localNodes.size();
-        NestedDissectionRecursion
-        ( rightChild, rightPerm, sepTree, eTree, parent, off+leftChildSize,
-          numSeps, cutoff );
-        node.children[0] = eTree.localNodes.size();
-        NestedDissectionRecursion
-        ( leftChild, leftPerm, sepTree, eTree, parent, off, 
-          numSeps, cutoff );
+        NestedDissectionChildren
+        ( leftChild, leftPerm, rightChild, rightPerm, sepTree, eTree,
+          parent, off, numSeps, cutoff, orderLeaves, threaded );
     }
 }
 
@@ -249,7 +646,9 @@ NestedDissectionRecursion
         bool sequential=true,
         int numDistSeps=1, 
         int numSeqSeps=1,
-        int cutoff=128 )
+        int cutoff=128,
+        bool orderLeaves=false,
+        bool threaded=false )
 {
     DEBUG_ONLY(CallStackEntry cse("NestedDissectionRecursion"))
     const int distDepth = sepTree.distSeps.size();
@@ -356,7 +755,8 @@ NestedDissectionRecursion
         const int newOff = ( childIsOnLeft ? off : off+leftChildSize );
         NestedDissectionRecursion
         ( child, newPerm, sepTree, eTree, depth+1, newOff, 
-          childIsOnLeft, sequential, numDistSeps, numSeqSeps, cutoff );
+          childIsOnLeft, sequential, numDistSeps, numSeqSeps, cutoff, 
+          orderLeaves, threaded );
     }
     else if( graph.NumSources() <= cutoff )
     {
@@ -474,17 +874,23 @@ NestedDissectionRecursion
         for( int s=0; s<rightChildSize; ++s )
             rightPerm[s] = perm.GetLocal( inverseMap[s+leftChildSize] );
 
-        // Update right then left so that, once we later reverse the order 
-        // of the nodes, the left node will be ordered first
         const int parent=0;
-        localNode.children[1] = eTree.localNodes.size();
-        NestedDissectionRecursion
-        ( rightChild, rightPerm, sepTree, eTree, parent, off+leftChildSize, 
-          numSeqSeps, cutoff );
-        localNode.children[0] = eTree.localNodes.size();
-        NestedDissectionRecursion
-        ( leftChild, leftPerm, sepTree, eTree, parent, off, 
-          numSeqSeps, cutoff );
+#ifdef HAVE_OPENMP
+        if( threaded )
+        {
+            #pragma omp parallel
+            {
+                #pragma omp single nowait
+                NestedDissectionChildren
+                ( leftChild, leftPerm, rightChild, rightPerm, sepTree, eTree,
+                  parent, off, numSeqSeps, cutoff, orderLeaves, true );
+            }
+            return;
+        }
+#endif // ifdef HAVE_OPENMP
+        NestedDissectionChildren
+        ( leftChild, leftPerm, rightChild, rightPerm, sepTree, eTree,
+          parent, off, numSeqSeps, cutoff, orderLeaves, false );
     }
 }
 
@@ -498,7 +904,11 @@ NestedDissection
         int numDistSeps, 
         int numSeqSeps, 
         int cutoff,
-        bool storeFactRecvInds )
+        bool storeFactRecvInds,
+        double maxZeroRatio,
+        double maxMemoryGrowth,
+        bool orderLeaves,
+        bool threaded )
 {
     DEBUG_ONLY(CallStackEntry cse("NestedDissection"))
     // NOTE: There is a potential memory leak here if these data structures 
@@ -520,16 +930,18 @@ NestedDissection
         perm.SetLocal( s, s+firstLocalSource );
     NestedDissectionRecursion
     ( graph, perm, sepTree, eTree, 0, 0, false, sequential, 
-      numDistSeps, numSeqSeps, cutoff );
+      numDistSeps, numSeqSeps, cutoff, orderLeaves, threaded );
 
     ReverseOrder( sepTree, eTree );
+    Amalgamate
+    ( sepTree, eTree, info.amalgamation, maxZeroRatio, maxMemoryGrowth );
 
     // Construct the distributed reordering    
     BuildMap( graph, sepTree, map );
     DEBUG_ONLY(EnsurePermutation( map ))
 
     // Run the symbolic analysis
-    SymmetricAnalysis( eTree, info, storeFactRecvInds );
+    SymmetricAnalysis( eTree, info, storeFactRecvInds, threaded );
 }
 
 inline int 
@@ -777,6 +1189,49 @@ Bisect
     BuildChildFromPerm( graph, perm, sizes[0], sizes[1], onLeft, child );
     return sizes[2];
 }
+
+inline void
+MinimumDegree( const Graph& graph, std::vector<int>& perm )
+{
+    DEBUG_ONLY(CallStackEntry cse("MinimumDegree"))
+    // METIS assumes that there are no self-connections or connections 
+    // outside the sources, so we must manually remove them from our graph
+    const int numSources = graph.NumSources();
+    std::vector<idx_t> xAdj( numSources+1 );
+    std::vector<idx_t> adjacency;
+    adjacency.reserve( graph.NumEdges() );
+    for( int s=0; s<numSources; ++s )
+    {
+        xAdj[s] = adjacency.size();
+        const int numConnections = graph.NumConnections( s );
+        const int edgeOff = graph.EdgeOffset( s );
+        for( int t=0; t<numConnections; ++t )
+        {
+            const int target = graph.Target( edgeOff+t );
+            if( target != s && target < numSources )
+                adjacency.push_back( target );
+        }
+    }
+    xAdj[numSources] = adjacency.size();
+    // Avoid handing METIS a null pointer for an edgeless graph
+    if( adjacency.size() == 0 )
+        adjacency.push_back( 0 );
+
+    // Use the custom METIS interface
+    idx_t nvtxs = numSources;
+    std::vector<idx_t> order( numSources );
+    if( numSources != 0 )
+    {
+        const int retval = 
+            CliqMinimumDegree( &nvtxs, &xAdj[0], &adjacency[0], &order[0] );
+        if( retval != METIS_OK )
+            RuntimeError("CliqMinimumDegree failed with error code ",retval);
+    }
+    perm.resize( numSources );
+    for( int s=0; s<numSources; ++s )
+        perm[s] = order[s];
+    DEBUG_ONLY(EnsurePermutation( perm ))
+}
 #endif // HAVE_PARMETIS
 
 inline void
@@ -14,25 +14,112 @@
 
 namespace cliq {
 
+// If 'threaded' is true and Clique was configured with OpenMP support, then
+// disjoint subtrees of the local elimination tree are analyzed concurrently
+// as OpenMP tasks, and each parent is analyzed once both of its children have
+// been. The distributed nodes are then analyzed as usual.
 void SymmetricAnalysis
 ( const DistSymmElimTree& eTree, DistSymmInfo& info, 
-  bool storeFactRecvInds=true );
+  bool storeFactRecvInds=true, bool threaded=false );
+
+// One step of the symbolic factorization of a node which owns the indices
+// [off,off+size): the strictly sorted lower structures of its two children 
+// and its original lower structure are merged in a single pass, which yields
+// the lower structure of the node as well as the relative indices of each of 
+// the three input structures into the front (whose first 'size' indices are
+// those of the node). The lower structure is accumulated within 'scratch',
+// which can be reused between calls so that only the outputs are allocated.
+void MergeStructs
+( Int off, Int size,
+  const std::vector<Int>& leftStruct, 
+  const std::vector<Int>& rightStruct,
+  const std::vector<Int>& origStruct,
+  std::vector<Int>& lowerStruct,
+  std::vector<Int>& leftRelInds, 
+  std::vector<Int>& rightRelInds,
+  std::vector<Int>& origRelInds,
+  std::vector<Int>& scratch );
 
 //----------------------------------------------------------------------------//
 // Implementation begins here                                                 //
 //----------------------------------------------------------------------------//
 
+// Set the relative indices of the entries of a structure which lie within
+// the node's own indices and return the number of such entries
+inline Int
+NodeRelativeIndices
+( Int off, Int size, const std::vector<Int>& structure, 
+  std::vector<Int>& relInds )
+{
+    const Int numInds = structure.size();
+    relInds.resize( numInds );
+    Int i=0;
+    for( ; i<numInds && structure[i] < off+size; ++i )
+    {
+        DEBUG_ONLY(
+            if( structure[i] < off )
+                LogicError("Structure contained a descendant index");
+        )
+        relInds[i] = structure[i] - off;
+    }
+    return i;
+}
+
+inline void
+MergeStructs
+( Int off, Int size,
+  const std::vector<Int>& leftStruct, 
+  const std::vector<Int>& rightStruct,
+  const std::vector<Int>& origStruct,
+  std::vector<Int>& lowerStruct,
+  std::vector<Int>& leftRelInds, 
+  std::vector<Int>& rightRelInds,
+  std::vector<Int>& origRelInds,
+  std::vector<Int>& scratch )
+{
+    DEBUG_ONLY(CallStackEntry cse("MergeStructs"))
+    const Int numLeft = leftStruct.size();
+    const Int numRight = rightStruct.size();
+    const Int numOrig = origStruct.size();
+    Int l = NodeRelativeIndices( off, size, leftStruct, leftRelInds );
+    Int r = NodeRelativeIndices( off, size, rightStruct, rightRelInds );
+    Int o = NodeRelativeIndices( off, size, origStruct, origRelInds );
+
+    const Int maxLowerSize = (numLeft-l) + (numRight-r) + (numOrig-o);
+    if( Int(scratch.size()) < maxLowerSize )
+        scratch.resize( maxLowerSize );
+    const Int sentinel = std::numeric_limits<Int>::max();
+    Int k=0;
+    while( l < numLeft || r < numRight || o < numOrig )
+    {
+        const Int leftNext = ( l < numLeft ? leftStruct[l] : sentinel );
+        const Int rightNext = ( r < numRight ? rightStruct[r] : sentinel );
+        const Int origNext = ( o < numOrig ? origStruct[o] : sentinel );
+        const Int next = std::min( std::min(leftNext,rightNext), origNext );
+        const Int relInd = size + k;
+        if( leftNext == next )
+            leftRelInds[l++] = relInd;
+        if( rightNext == next )
+            rightRelInds[r++] = relInd;
+        if( origNext == next )
+            origRelInds[o++] = relInd;
+        scratch[k++] = next;
+    }
+    lowerStruct.assign( scratch.begin(), scratch.begin()+k );
+}
+
 void LocalSymmetricAnalysis
-( const DistSymmElimTree& eTree, DistSymmInfo& info );
+( const DistSymmElimTree& eTree, DistSymmInfo& info, bool threaded=false );
 void DistSymmetricAnalysis
 ( const DistSymmElimTree& eTree, DistSymmInfo& info, 
   bool storeFactRecvInds=true );
 
 inline void SymmetricAnalysis
-( const DistSymmElimTree& eTree, DistSymmInfo& info, bool storeFactRecvInds )
+( const DistSymmElimTree& eTree, DistSymmInfo& info, 
+  bool storeFactRecvInds, bool threaded )
 {
     DEBUG_ONLY(CallStackEntry cse("SymmetricAnalysis"))
-    LocalSymmetricAnalysis( eTree, info );
+    LocalSymmetricAnalysis( eTree, info, threaded );
     DistSymmetricAnalysis( eTree, info, storeFactRecvInds );
 }
 
@@ -14,7 +14,12 @@ namespace {
 bool cliqueInitializedElemental; 
 int numCliqueInits = 0;
 cliq::Args* args = 0;
+#ifdef HAVE_OPENMP
+// Each thread executing tasks within the local factorization has its own stack
+DEBUG_ONLY(thread_local std::stack<std::string> callStack)
+#else
 DEBUG_ONLY(std::stack<std::string> callStack)
+#endif
 }
 
 namespace cliq {
@@ -40,6 +45,9 @@ void PrintConfig( std::ostream& os )
 #endif
 #ifdef HAVE_PARMETIS
     os << "  HAVE_PARMETIS\n";
+#endif
+#ifdef HAVE_OPENMP
+    os << "  HAVE_OPENMP\n";
 #endif
     El::PrintConfig( os );
 }
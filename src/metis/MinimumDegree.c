@@ -0,0 +1,67 @@
+/*
+ * Copyright 1997, Regents of the University of Minnesota
+ * Modified by Jack Poulson, 2012
+ */
+#include "metislib.h"
+
+/* Computes a multiple minimum degree ordering of a (small) graph, where
+   vertex i is mapped to position order[i]. As with METIS_NodeND, METIS_OK
+   is returned upon success and an error code otherwise. */
+int CliqMinimumDegree
+( idx_t *nvtxs, idx_t *xadj, idx_t *adjncy, idx_t *order )
+{
+  int sigrval=0;
+  idx_t options[METIS_NOPTIONS];
+  /* these are modified after the signal catcher's setjmp */
+  graph_t * volatile graph=NULL;
+  ctrl_t * volatile ctrl=NULL;
+
+  if( *nvtxs == 0 )
+    return METIS_OK;
+
+  /* set up malloc cleaning code and signal catchers */
+  if( !gk_malloc_init() )
+    return METIS_ERROR_MEMORY;
+
+  gk_sigtrap();
+
+  if( (sigrval = gk_sigcatch()) != 0 ) 
+    goto SIGTHROW;
+
+  /* set up the run time parameters */
+  METIS_SetDefaultOptions(options);
+  options[METIS_OPTION_COMPRESS] = 0;
+  ctrl = SetupCtrl(METIS_OP_OMETIS, options, 1, 3, NULL, NULL);
+  if (!ctrl) {
+    gk_siguntrap();
+    gk_malloc_cleanup(0);
+    return METIS_ERROR_INPUT;
+  }
+
+  graph = SetupGraph(ctrl, *nvtxs, 1, xadj, adjncy, NULL, NULL, NULL);
+
+  ASSERT(CheckGraph(graph, 0, 1));
+
+  /* allocate workspace memory */
+  AllocateWorkSpace(ctrl, graph);
+
+  /* compute the ordering (MMDOrder temporarily shifts xadj and adjncy to 
+     one-based indexing) */
+  MMDOrder( ctrl, graph, order, *nvtxs );
+
+  /* clean up */
+  FreeGraph((graph_t **)&graph);
+  FreeCtrl((ctrl_t **)&ctrl);
+
+SIGTHROW:
+  /* if an error was caught, then free whatever was still in use */
+  if( graph != NULL )
+    FreeGraph((graph_t **)&graph);
+  if( ctrl != NULL )
+    FreeCtrl((ctrl_t **)&ctrl);
+
+  gk_siguntrap();
+  gk_malloc_cleanup(0);
+
+  return metis_rcode(sigrval);
+}
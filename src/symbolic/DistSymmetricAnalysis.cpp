@@ -121,7 +121,8 @@ inline void GetLowerStruct
 inline void ComputeStructAndRelInds
 ( Int theirSize, const std::vector<Int>& theirLowerStruct,
   const DistSymmNode& node,         const DistSymmNode& childNode, 
-        DistSymmNodeInfo& nodeInfo, const DistSymmNodeInfo& childNodeInfo )
+        DistSymmNodeInfo& nodeInfo, const DistSymmNodeInfo& childNodeInfo,
+  std::vector<Int>& scratch )
 {
     const std::vector<Int>& myLowerStruct = childNodeInfo.lowerStruct;
     DEBUG_ONLY(
@@ -148,43 +149,30 @@ inline void ComputeStructAndRelInds
         }
     )
 
-    // Combine the children's structure
-    auto childrenStruct = Union( myLowerStruct, theirLowerStruct );
-
-    // Now add in the original lower structure
-    auto partialStruct = Union( childrenStruct, node.lowerStruct );
-
-    // Now the node indices
-    std::vector<Int> nodeInds( node.size );
-    for( int i=0; i<node.size; ++i )
-        nodeInds[i] = node.off + i;
-    auto fullStruct = Union( nodeInds, partialStruct );
-
-    // Construct the relative indices of the original lower structure
-    nodeInfo.origLowerRelInds = RelativeIndices( node.lowerStruct, fullStruct );
-
-    // Construct the relative indices of the children
+    // Merge the children's structures with the original lower structure and 
+    // form all of the relative indices in one pass
     if( childNode.onLeft )
     {
         nodeInfo.leftSize = childNodeInfo.size;
         nodeInfo.rightSize = theirSize;
-        nodeInfo.leftRelInds = RelativeIndices( myLowerStruct, fullStruct );
-        nodeInfo.rightRelInds = RelativeIndices( theirLowerStruct, fullStruct );
+        MergeStructs
+        ( node.off, node.size, 
+          myLowerStruct, theirLowerStruct, node.lowerStruct,
+          nodeInfo.lowerStruct, nodeInfo.leftRelInds, nodeInfo.rightRelInds,
+          nodeInfo.origLowerRelInds, scratch );
     }
     else
     {
         nodeInfo.leftSize = theirSize;
         nodeInfo.rightSize = childNodeInfo.size;
-        nodeInfo.leftRelInds = RelativeIndices( theirLowerStruct, fullStruct );
-        nodeInfo.rightRelInds = RelativeIndices( myLowerStruct, fullStruct );
+        MergeStructs
+        ( node.off, node.size, 
+          theirLowerStruct, myLowerStruct, node.lowerStruct,
+          nodeInfo.lowerStruct, nodeInfo.leftRelInds, nodeInfo.rightRelInds,
+          nodeInfo.origLowerRelInds, scratch );
     }
-
-    // Form lower structure of this node by removing the node indices
-    const int lowerStructSize = fullStruct.size() - node.size;
-    nodeInfo.lowerStruct.resize( lowerStructSize );
-    for( int i=0; i<lowerStructSize; ++i )
-        nodeInfo.lowerStruct[i] = fullStruct[node.size+i];
     DEBUG_ONLY(
+        const int lowerStructSize = nodeInfo.lowerStruct.size();
         // Ensure that the root process computed a lowerStruct of the same size
         int rootLowerStructSize;
         if( mpi::Rank(node.comm) == 0 )
@@ -371,6 +359,8 @@ void DistSymmetricAnalysis
 ( const DistSymmElimTree& eTree, DistSymmInfo& info, bool computeFactRecvInds )
 {
     DEBUG_ONLY(CallStackEntry cse("DistSymmetricAnalysis"))
+    // Release the grids, communicators, and plans of any previous analysis
+    info.EmptyDistNodes();
     const Unsigned numDist = eTree.distNodes.size();
     info.distNodes.resize( numDist );
 
@@ -391,8 +381,10 @@ void DistSymmetricAnalysis
     bottomDist.leftSize = -1; // not needed, could compute though
     bottomDist.rightSize = -1; // not needed, could compute though
 
-    // Perform the distributed part of the symbolic factorization
+    // Perform the distributed part of the symbolic factorization, reusing 
+    // a single merge workspace for every node
     Int myOff = bottomDist.myOff + bottomDist.size;
+    std::vector<Int> scratch;
     for( Unsigned s=1; s<numDist; ++s )
     {
         const DistSymmNode& node = eTree.distNodes[s];
@@ -419,7 +411,7 @@ void DistSymmetricAnalysis
         // a wide variety of relative indices
         ComputeStructAndRelInds
         ( theirSize, theirLowerStruct, node, childNode, 
-          nodeInfo, childNodeInfo );
+          nodeInfo, childNodeInfo, scratch );
 
         myOff += nodeInfo.size;
     }
@@ -12,105 +12,158 @@
 
 namespace cliq {
 
-void LocalSymmetricAnalysis( const DistSymmElimTree& eTree, DistSymmInfo& info )
+// Subtrees whose nodes have fewer than this many indices in total (counting
+// both the node indices and the original lower structures) are analyzed by 
+// the task which reaches them rather than being split into further tasks
+const Int minLocalAnalysisTaskSize = 10000;
+
+// Perform the symbolic factorization of local node 's', whose children must
+// have already been analyzed
+inline void
+LocalNodeAnalysis
+( const DistSymmElimTree& eTree, DistSymmInfo& info, Int s, 
+  std::vector<Int>& scratch )
 {
-    DEBUG_ONLY(CallStackEntry cse("LocalSymmetricAnalysis"))
-    const Int numNodes = eTree.localNodes.size();
-    info.localNodes.resize( numNodes );
+    const SymmNode& node = *eTree.localNodes[s];
+    SymmNodeInfo& nodeInfo = info.localNodes[s];
+    nodeInfo.size = node.size;
+    nodeInfo.off= node.off;
+    nodeInfo.parent = node.parent;
+    nodeInfo.children = node.children;
+    nodeInfo.origLowerStruct = node.lowerStruct;
 
-    // Perform the symbolic factorization
-    Int myOff= 0;
-    for( Int s=0; s<numNodes; ++s )
+    const Int numChildren = node.children.size();
+    DEBUG_ONLY(
+        if( numChildren != 0 && numChildren != 2 )
+            LogicError("Tree must be built from bisections");
+    )
+    if( numChildren == 2 )
     {
-        const SymmNode& node = *eTree.localNodes[s];
-        SymmNodeInfo& nodeInfo = info.localNodes[s];
-        nodeInfo.size = node.size;
-        nodeInfo.off= node.off;
-        nodeInfo.myOff= myOff;
-        nodeInfo.parent = node.parent;
-        nodeInfo.children = node.children;
-        nodeInfo.origLowerStruct = node.lowerStruct;
-
-        const Int numChildren = node.children.size();
+        const Int left = node.children[0];
+        const Int right = node.children[1];
+        SymmNodeInfo& leftChild = info.localNodes[left];
+        SymmNodeInfo& rightChild = info.localNodes[right];
+        leftChild.onLeft = true;
+        rightChild.onLeft = false;
         DEBUG_ONLY(
-            if( numChildren != 0 && numChildren != 2 )
-                LogicError("Tree must be built from bisections");
+            if( !IsStrictlySorted(leftChild.lowerStruct) )
+            {
+                if( IsSorted(leftChild.lowerStruct) )
+                    LogicError("Repeat in left lower struct");
+                else
+                    LogicError("Left lower struct not sorted");
+            }
+            if( !IsStrictlySorted(rightChild.lowerStruct) )
+            {
+                if( IsSorted(rightChild.lowerStruct) )
+                    LogicError("Repeat in right lower struct");
+                else
+                    LogicError("Right lower struct not sorted");
+            }
+            if( !IsStrictlySorted(node.lowerStruct) )
+            {
+                if( IsSorted(node.lowerStruct) )
+                    LogicError("Repeat in original lower struct");
+                else
+                    LogicError("Original lower struct not sorted");
+            }
         )
-        if( numChildren == 2 )
-        {
-            const Int left = node.children[0];
-            const Int right = node.children[1];
-            SymmNodeInfo& leftChild = info.localNodes[left];
-            SymmNodeInfo& rightChild = info.localNodes[right];
-            leftChild.onLeft = true;
-            rightChild.onLeft = false;
-            DEBUG_ONLY(
-                if( !IsStrictlySorted(leftChild.lowerStruct) )
-                {
-                    if( IsSorted(leftChild.lowerStruct) )
-                        LogicError("Repeat in left lower struct");
-                    else
-                        LogicError("Left lower struct not sorted");
-                }
-                if( !IsStrictlySorted(rightChild.lowerStruct) )
-                {
-                    if( IsSorted(rightChild.lowerStruct) )
-                        LogicError("Repeat in right lower struct");
-                    else
-                        LogicError("Right lower struct not sorted");
-                }
-                if( !IsStrictlySorted(node.lowerStruct) )
-                {
-                    if( IsSorted(node.lowerStruct) )
-                        LogicError("Repeat in original lower struct");
-                    else
-                        LogicError("Original lower struct not sorted");
-                }
-            )
 
-            // Combine the structures of the children
-            auto childrenStruct = 
-                Union( leftChild.lowerStruct, rightChild.lowerStruct );
+        // Merge the structures of the children with the original lower
+        // structure and form all of the relative indices in one pass
+        MergeStructs
+        ( node.off, node.size, 
+          leftChild.lowerStruct, rightChild.lowerStruct, node.lowerStruct,
+          nodeInfo.lowerStruct, 
+          nodeInfo.leftRelInds, nodeInfo.rightRelInds, 
+          nodeInfo.origLowerRelInds, scratch );
+        ContiguousRuns( nodeInfo.leftRunStarts, nodeInfo.leftRelInds );
+        ContiguousRuns( nodeInfo.rightRunStarts, nodeInfo.rightRelInds );
+    }
+    else // numChildren == 0, so this is a leaf node 
+    {
+        nodeInfo.lowerStruct = node.lowerStruct;
+        
+        // Construct the trivial relative indices of the original structure
+        const Int numOrigLowerInds = node.lowerStruct.size();
+        nodeInfo.origLowerRelInds.resize( numOrigLowerInds );
+        for( Int i=0; i<numOrigLowerInds; ++i )
+            nodeInfo.origLowerRelInds[i] = i + nodeInfo.size;
+    }
+}
 
-            // Now add in the original lower structure
-            auto partialStruct = Union( node.lowerStruct, childrenStruct );
+#ifdef HAVE_OPENMP
+// Analyze the subtree rooted at local node 's', spawning the child subtrees
+// which are large enough as tasks. Each thread merges within its own scratch
+// buffer, which is safe since LocalNodeAnalysis contains no task scheduling
+// points.
+inline void
+LocalSubtreeAnalysis
+( const DistSymmElimTree& eTree, DistSymmInfo& info, 
+  const std::vector<Int>& subtreeSizes, 
+  std::vector<std::vector<Int>>& scratches, Int s )
+{
+    const SymmNode& node = *eTree.localNodes[s];
+    const Int numChildren = node.children.size();
+    for( Int c=0; c<numChildren; ++c )
+    {
+        const Int child = node.children[c];
+        #pragma omp task default(shared) firstprivate(child) \
+                if( subtreeSizes[child] >= minLocalAnalysisTaskSize )
+        LocalSubtreeAnalysis( eTree, info, subtreeSizes, scratches, child );
+    }
+    #pragma omp taskwait
 
-            // Now the node indices
-            std::vector<Int> nodeInds( node.size );
-            for( Int i=0; i<node.size; ++i )
-                nodeInds[i] = node.off+ i;
-            auto fullStruct = Union( partialStruct, nodeInds );
+    LocalNodeAnalysis( eTree, info, s, scratches[omp_get_thread_num()] );
+}
+#endif // ifdef HAVE_OPENMP
 
-            // Construct the relative indices of the original lower structure
-            nodeInfo.origLowerRelInds = 
-                RelativeIndices( node.lowerStruct, fullStruct );
+void LocalSymmetricAnalysis
+( const DistSymmElimTree& eTree, DistSymmInfo& info, bool threaded )
+{
+    DEBUG_ONLY(CallStackEntry cse("LocalSymmetricAnalysis"))
+    const Int numNodes = eTree.localNodes.size();
+    info.localNodes.resize( numNodes );
 
-            // Construct the relative indices of the children
-            nodeInfo.leftRelInds = 
-                RelativeIndices( leftChild.lowerStruct, fullStruct );
-            nodeInfo.rightRelInds =
-                RelativeIndices( rightChild.lowerStruct, fullStruct );
+    // The offsets into the local nodal vectors only depend upon the sizes
+    Int myOff = 0;
+    for( Int s=0; s<numNodes; ++s )
+    {
+        info.localNodes[s].myOff = myOff;
+        myOff += eTree.localNodes[s]->size;
+    }
 
-            // Form lower struct of this node by removing node indices
-            // (which take up the first node.size indices of fullStruct)
-            const Int lowerStructSize = fullStruct.size()-node.size;
-            nodeInfo.lowerStruct.resize( lowerStructSize );
-            for( Int i=0; i<lowerStructSize; ++i )
-                nodeInfo.lowerStruct[i] = fullStruct[node.size+i];
-        }
-        else // numChildren == 0, so this is a leaf node 
+#ifdef HAVE_OPENMP
+    if( threaded && numNodes > 1 )
+    {
+        // Since the nodes are stored in a post-ordering, each child is 
+        // visited before its parent
+        std::vector<Int> subtreeSizes( numNodes );
+        for( Int s=0; s<numNodes; ++s )
         {
-            nodeInfo.lowerStruct = node.lowerStruct;
-            
-            // Construct the trivial relative indices of the original structure
-            const Int numOrigLowerInds = node.lowerStruct.size();
-            nodeInfo.origLowerRelInds.resize( numOrigLowerInds );
-            for( Int i=0; i<numOrigLowerInds; ++i )
-                nodeInfo.origLowerRelInds[i] = i + nodeInfo.size;
+            const SymmNode& node = *eTree.localNodes[s];
+            subtreeSizes[s] = node.size + node.lowerStruct.size();
+            const Int numChildren = node.children.size();
+            for( Int c=0; c<numChildren; ++c )
+                subtreeSizes[s] += subtreeSizes[node.children[c]];
         }
 
-        myOff += nodeInfo.size;
+        std::vector<std::vector<Int>> scratches( omp_get_max_threads() );
+        #pragma omp parallel
+        {
+            #pragma omp single nowait
+            LocalSubtreeAnalysis
+            ( eTree, info, subtreeSizes, scratches, numNodes-1 );
+        }
+        return;
     }
+#endif // ifdef HAVE_OPENMP
+
+    // Perform the symbolic factorization, reusing a single workspace for the
+    // merged structures
+    std::vector<Int> scratch;
+    for( Int s=0; s<numNodes; ++s )
+        LocalNodeAnalysis( eTree, info, s, scratch );
 }
 
 } // namespace cliq
@@ -144,20 +144,27 @@ main( int argc, char* argv[] )
         {
             if( repeat != 0 )
             {
-                // Reset to an unfactored, implicitly symmetric frontal tree
-                if( commRank == 0 )
-                    std::cout << "Resetting frontal tree." << std::endl;
-                ChangeFrontType( frontTree, SYMM_2D );
+                // Shift the diagonal of A without changing its sparsity
+                const int numLocalEntries = A.NumLocalEntries();
+                double* values = A.ValueBuffer();
+                for( int k=0; k<numLocalEntries; ++k )
+                    if( A.Row(k) == A.Col(k) )
+                        values[k] = 6. + repeat;
 
-                // Randomize the fronts
+                // Refill the frontal tree using the cached pattern
+                if( commRank == 0 )
+                {
+                    std::cout << "Refilling frontal tree...";
+                    std::cout.flush();
+                }
+                mpi::Barrier( comm );
+                const double refillStart = mpi::Time();
+                frontTree.Refactor( A );
+                mpi::Barrier( comm );
+                const double refillStop = mpi::Time();
                 if( commRank == 0 )
-                    std::cout << "Randomizing fronts." << std::endl;
-                const int numDistFronts = frontTree.distFronts.size();
-                const int numLocalFronts = frontTree.localFronts.size();
-                for( int s=0; s<numLocalFronts; ++s )
-                    El::MakeUniform( frontTree.localFronts[s].frontL );
-                for( int s=1; s<numDistFronts; ++s )
-                    El::MakeUniform( frontTree.distFronts[s].front2dL );
+                    std::cout << "done, " << refillStop-refillStart 
+                              << " seconds" << std::endl;
             }
 
             if( commRank == 0 )
@@ -167,6 +174,7 @@ main( int argc, char* argv[] )
             }
             mpi::Barrier( comm );
             const double ldlStart = mpi::Time();
+            // Keep the exchange buffers for the following refactorizations
             if( intraPiv )
                 LDL( info, frontTree, LDL_INTRAPIV_1D );
             else
@@ -182,9 +190,10 @@ main( int argc, char* argv[] )
                 std::cout << "Solving against random right-hand side...";
                 std::cout.flush();
             }
+            DistMultiVec<double> x( N, 1, comm ), y( N, 1, comm );
+            MakeUniform( x );
+            Multiply( 1., A, x, 0., y );
             const double solveStart = mpi::Time();
-            DistMultiVec<double> y( N, 1, comm );
-            MakeUniform( y );
             DistNodalMultiVec<double> yNodal;
             yNodal.Pull( inverseMap, info, y );
             Solve( info, frontTree, yNodal );
@@ -195,7 +204,14 @@ main( int argc, char* argv[] )
                 std::cout << "done, " << solveStop-solveStart << " seconds"
                           << std::endl;
 
-            // TODO: Check residual error
+            std::vector<double> xNorms, errorNorms;
+            Norms( x, xNorms );
+            Axpy( -1., x, y );
+            Norms( y, errorNorms );
+            if( commRank == 0 )
+                std::cout << "|| x ||_2 = " << xNorms[0] << ", "
+                          << "|| error ||_2 = " << errorNorms[0] << "\n"
+                          << std::endl;
         }
     }
     catch( std::exception& e ) { ReportException(e); }
@@ -33,6 +33,10 @@ main( int argc, char* argv[] )
             ("--numSeqSeps",
              "number of separators to try per sequential partition",1);
         const int cutoff = Input("--cutoff","cutoff for nested dissection",128);
+        const bool mixed = Input
+            ("--mixed","factor in single precision and refine?",false);
+        const int maxRefineIts = Input
+            ("--maxRefineIts","maximum number of refinement steps",10);
         const bool print = Input("--print","print matrix?",false);
         const bool display = Input("--display","display matrix?",false);
         ProcessInput();
@@ -114,12 +118,22 @@ main( int argc, char* argv[] )
             std::cout.flush();
         }
         const double solveStart = mpi::Time();
-        SymmetricSolve
-        ( A, Y, false, sequential, numDistSeps, numSeqSeps, cutoff );
+        int numRefineIts = 0;
+        if( mixed )
+            numRefineIts = SymmetricMixedSolve
+            ( A, Y, false, maxRefineIts, 
+              sequential, numDistSeps, numSeqSeps, cutoff );
+        else
+            SymmetricSolve
+            ( A, Y, false, sequential, numDistSeps, numSeqSeps, cutoff );
         const double solveStop = mpi::Time();
         if( commRank == 0 )
+        {
             std::cout << "done, " << solveStop-solveStart << " seconds"
                       << std::endl;
+            if( mixed )
+                std::cout << numRefineIts << " refinement steps" << std::endl;
+        }
 
         if( commRank == 0 )
             std::cout << "Checking error in computed solution..." << std::endl;
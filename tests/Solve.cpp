@@ -28,6 +28,15 @@ main( int argc, char* argv[] )
         const bool selInv = Input("--selInv","selectively invert?",false);
         const bool intraPiv = Input("--intraPiv","pivot within fronts?",false);
         const bool natural = Input("--natural","analytical nested-diss?",true);
+        const bool threaded = Input
+            ("--threaded","analyze/factor local subtrees with OpenMP tasks?",
+             false);
+        const bool pipelined = Input
+            ("--pipelined","overlap child update exchange with fact.?",false);
+        const bool stash = Input
+            ("--stash",
+             "assemble each coupling from one endpoint via the off-process "
+             "stash?",false);
         const bool sequential = Input
             ("--sequential","sequential partitions?",true);
         const int numDistSeps = Input
@@ -39,6 +48,31 @@ main( int argc, char* argv[] )
         const int nbFact = Input("--nbFact","factorization blocksize",96);
         const int nbSolve = Input("--nbSolve","solve blocksize",96);
         const int cutoff = Input("--cutoff","cutoff for nested dissection",128);
+        const double maxZeroRatio = Input
+            ("--maxZeroRatio","max fraction of zeros in amalgamated fronts",0.);
+        const double maxMemoryGrowth = Input
+            ("--maxMemoryGrowth","max memory growth from amalgamation",0.1);
+        const bool orderLeaves = Input
+            ("--orderLeaves","minimum degree ordering of leaves?",false);
+        const std::string analysisFile = Input
+            ("--analysisFile","basename for saving/loading the analysis",
+             std::string(""));
+        const std::string outOfCoreFile = Input
+            ("--outOfCoreFile","basename for out-of-core factor storage",
+             std::string(""));
+        const std::string factorFile = Input
+            ("--factorFile","basename for saving/attaching the factorization",
+             std::string(""));
+        const bool refine = Input
+            ("--refine","iteratively refine the solution?",false);
+        const int maxRefineIts = Input
+            ("--maxRefineIts","maximum number of refinement steps",10);
+        const int panelWidth = Input
+            ("--panelWidth","stream single RHS through panels of this width",
+             0);
+        const int sparseRows = Input
+            ("--sparseRows",
+             "also solve with a RHS supported on (and keep) this many rows",0);
         const bool print = Input("--print","print matrix?",false);
         const bool display = Input("--display","display matrix?",false);
         ProcessInput();
@@ -56,7 +90,7 @@ main( int argc, char* argv[] )
         const double fillStart = mpi::Time();
         const int firstLocalRow = A.FirstLocalRow();
         const int localHeight = A.LocalHeight();
-        A.StartAssembly();
+        A.StartAssembly( stash );
         A.Reserve( 7*localHeight );
         for( int iLocal=0; iLocal<localHeight; ++iLocal )
         {
@@ -65,6 +99,32 @@ main( int argc, char* argv[] )
             const int y = (i/n1) % n2;
             const int z = i/(n1*n2);
 
+            if( stash )
+            {
+                // Add each coupling from the vertex with the lower index, 
+                // which sends updates to rows owned by other processes 
+                // through the stash. The diagonal entry is added in two 
+                // halves so that duplicate updates are summed.
+                A.Update( i, i, 3. );
+                A.Update( i, i, 3. );
+                if( x != n1-1 )
+                {
+                    A.Update( i, i+1, -1. );
+                    A.Update( i+1, i, -1. );
+                }
+                if( y != n2-1 )
+                {
+                    A.Update( i, i+n1, -1. );
+                    A.Update( i+n1, i, -1. );
+                }
+                if( z != n3-1 )
+                {
+                    A.Update( i, i+n1*n2, -1. );
+                    A.Update( i+n1*n2, i, -1. );
+                }
+                continue;
+            }
+
             A.Update( i, i, 6. );
             if( x != 0 )
                 A.Update( i, i-1, -1. );
@@ -79,7 +139,7 @@ main( int argc, char* argv[] )
             if( z != n3-1 )
                 A.Update( i, i+n1*n2, -1. );
         } 
-        A.StopAssembly();
+        A.StopAssembly( true );
         mpi::Barrier( comm );
         const double fillStop =  mpi::Time();
         if( commRank == 0 )
@@ -124,17 +184,43 @@ main( int argc, char* argv[] )
         DistSymmInfo info;
         DistSeparatorTree sepTree;
         DistMap map, inverseMap;
-        if( natural )
+        AnalysisOptions analysisOptions;
+        analysisOptions.natural = natural;
+        analysisOptions.cutoff = cutoff;
+        analysisOptions.maxZeroRatio = maxZeroRatio;
+        analysisOptions.maxMemoryGrowth = maxMemoryGrowth;
+        if( !natural )
+        {
+            analysisOptions.sequential = sequential;
+            analysisOptions.numDistSeps = numDistSeps;
+            analysisOptions.numSeqSeps = numSeqSeps;
+            analysisOptions.orderLeaves = orderLeaves;
+        }
+        const bool loaded = 
+            ( analysisFile != "" && 
+              LoadAnalysis
+              ( graph, map, sepTree, info, analysisFile, analysisOptions ) );
+        if( loaded )
+        {
+            if( commRank == 0 )
+                std::cout << "loaded from " << analysisFile << "...";
+        }
+        else if( natural )
         {
             NaturalNestedDissection
-            ( n1, n2, n3, graph, map, sepTree, info, cutoff );
+            ( n1, n2, n3, graph, map, sepTree, info, cutoff, false,
+              maxZeroRatio, maxMemoryGrowth, threaded );
         }
         else
         {
             NestedDissection
             ( graph, map, sepTree, info, 
-              sequential, numDistSeps, numSeqSeps, cutoff );
+              sequential, numDistSeps, numSeqSeps, cutoff, false,
+              maxZeroRatio, maxMemoryGrowth, orderLeaves, threaded );
         }
+        if( analysisFile != "" && !loaded )
+            SaveAnalysis
+            ( graph, map, sepTree, info, analysisFile, analysisOptions );
         map.FormInverse( inverseMap );
         mpi::Barrier( comm );
         const double nestedStop = mpi::Time();
@@ -150,8 +236,15 @@ main( int argc, char* argv[] )
             std::cout << "\n"
                       << "On the root process:\n"
                       << "-----------------------------------------\n"
-                      << localNodes << " local nodes\n"
-                      << distNodes  << " distributed nodes\n"
+                      << localNodes << " local nodes\n";
+            if( maxZeroRatio > 0 )
+                std::cout << info.amalgamation.numMerged 
+                          << " local nodes removed by amalgamation\n"
+                          << info.amalgamation.extraEntries 
+                          << " explicit zeros added to "
+                          << info.amalgamation.origEntries 
+                          << " local factor entries\n";
+            std::cout << distNodes  << " distributed nodes\n"
                       << rootSepSize << " vertices in root separator\n"
                       << std::endl;
         }
@@ -172,6 +265,8 @@ main( int argc, char* argv[] )
         mpi::Barrier( comm );
         const double buildStart = mpi::Time();
         DistSymmFrontTree<double> frontTree( A, map, sepTree, info, false );
+        if( outOfCoreFile != "" )
+            frontTree.SetOutOfCore( outOfCoreFile );
         mpi::Barrier( comm );
         const double buildStop = mpi::Time();
         if( commRank == 0 )
@@ -241,7 +336,20 @@ main( int argc, char* argv[] )
                 frontType = ( selInv ? LDL_SELINV_1D
                                      : LDL_1D );
         }
-        LDL( info, frontTree, frontType );
+        const bool attached = 
+            ( factorFile != "" && 
+              AttachFactorization( info, frontTree, factorFile ) );
+        if( attached )
+        {
+            if( frontTree.frontType != frontType )
+                LogicError("The saved factorization is of another front type");
+            if( commRank == 0 )
+                std::cout << "attached to " << factorFile << "...";
+        }
+        else
+            LDL( info, frontTree, frontType, threaded, pipelined );
+        if( factorFile != "" && !attached )
+            SaveFactorization( info, frontTree, factorFile );
         mpi::Barrier( comm );
         const double ldlStop = mpi::Time();
         const double factTime = ldlStop - ldlStart;
@@ -265,6 +373,33 @@ main( int argc, char* argv[] )
                       << " MB\n"
                       << std::endl;
         }
+        if( !threaded && !attached )
+        {
+            if( commRank == 0 )
+                std::cout << "Peak memory usage for fronts during "
+                             "factorization..." << std::endl;
+            frontTree.PeakMemoryInfo
+            ( localEntries, minLocalEntries, maxLocalEntries, globalEntries );
+            const double stackEntries = 
+                frontTree.updateArena.PeakEntries();
+            const double postorderStackEntries = 
+                frontTree.updateArena.PostorderPeakEntries();
+            if( commRank == 0 )
+            {
+                std::cout 
+                  << "  min local: " << minLocalEntries*sizeof(double)/1e6 
+                  << " MB\n"
+                  << "  max local: " << maxLocalEntries*sizeof(double)/1e6 
+                  << " MB\n"
+                  << "  global:    " << globalEntries*sizeof(double)/1e6
+                  << " MB\n"
+                  << "  update stack on root: " 
+                  << stackEntries*sizeof(double)/1e6 << " MB (vs. " 
+                  << postorderStackEntries*sizeof(double)/1e6 
+                  << " MB in stored order)\n"
+                  << std::endl;
+            }
+        }
 
         if( commRank == 0 )
         {
@@ -273,7 +408,50 @@ main( int argc, char* argv[] )
         }
         El::SetBlocksize( nbSolve );
         double solveStart, solveStop;
-        if( solve2d )
+        int numRefineIts = 0;
+        double backwardError = 0;
+        if( refine )
+        {
+            mpi::Barrier( comm );
+            solveStart = mpi::Time();
+            numRefineIts = RefinedSolve
+            ( A, inverseMap, info, frontTree, Y, backwardError,
+              std::numeric_limits<double>::epsilon(), maxRefineIts );
+            mpi::Barrier( comm );
+            solveStop = mpi::Time();
+        }
+        else if( panelWidth > 0 )
+        {
+            // Submit the right-hand sides one at a time
+            const int localHeight = Y.LocalHeight();
+            std::vector<DistMultiVec<double>> y( numRhs );
+            std::vector<std::future<void>> futures( numRhs );
+            for( int j=0; j<numRhs; ++j )
+            {
+                y[j].SetComm( comm );
+                y[j].Resize( N, 1 );
+                for( int iLocal=0; iLocal<localHeight; ++iLocal )
+                    y[j].SetLocal( iLocal, 0, Y.GetLocal(iLocal,j) );
+            }
+            SolveSession<double> session
+            ( inverseMap, info, frontTree, panelWidth );
+            mpi::Barrier( comm );
+            solveStart = mpi::Time();
+            for( int j=0; j<numRhs; ++j )
+                futures[j] = session.Submit( y[j] );
+            session.Flush();
+            mpi::Barrier( comm );
+            solveStop = mpi::Time();
+            for( int j=0; j<numRhs; ++j )
+            {
+                futures[j].get();
+                for( int iLocal=0; iLocal<localHeight; ++iLocal )
+                    Y.SetLocal( iLocal, j, y[j].GetLocal(iLocal,0) );
+            }
+            if( commRank == 0 )
+                std::cout << session.NumPanelsSolved() << " panels...";
+        }
+        else if( solve2d )
         {
             DistNodalMatrix<double> YNodal;
             YNodal.Pull( inverseMap, info, Y );
@@ -301,6 +479,10 @@ main( int argc, char* argv[] )
             std::cout << "done, " << solveTime << " seconds, "
                       << solveGFlops << " GFlop/s" << std::endl;
 
+        if( refine && commRank == 0 )
+            std::cout << numRefineIts << " refinement steps, backward error "
+                      << backwardError << std::endl;
+
         if( commRank == 0 )
             std::cout << "Checking error in computed solution..." << std::endl;
         std::vector<double> XNorms, YNorms;
@@ -321,6 +503,57 @@ main( int argc, char* argv[] )
                           << std::endl;
             }
         }
+
+        if( sparseRows > 0 && !solve2d )
+        {
+            // Solve against a right-hand side which is only nonzero in the
+            // first rows while only requesting the last rows of the solution
+            if( commRank == 0 )
+            {
+                std::cout << "Solving against a sparse right-hand side...";
+                std::cout.flush();
+            }
+            DistMultiVec<double> b( N, 1, comm );
+            Zero( b );
+            const int firstLocalRow = b.FirstLocalRow();
+            const int localHeight = b.LocalHeight();
+            for( int iLocal=0; iLocal<localHeight; ++iLocal )
+                if( firstLocalRow+iLocal < sparseRows )
+                    b.SetLocal( iLocal, 0, 1. );
+            std::vector<int> requestedRows;
+            for( int i=std::max(N-sparseRows,0); i<N; ++i )
+                requestedRows.push_back( i );
+
+            DistMultiVec<double> xFull, xSparse;
+            xFull = b;
+            xSparse = b;
+            mpi::Barrier( comm );
+            const double fullStart = mpi::Time();
+            DistNodalMultiVec<double> xNodal( inverseMap, info, xFull );
+            Solve( info, frontTree, xNodal );
+            xNodal.Push( inverseMap, info, xFull );
+            mpi::Barrier( comm );
+            const double sparseStart = mpi::Time();
+            SparseSolve( inverseMap, info, frontTree, xSparse, requestedRows );
+            mpi::Barrier( comm );
+            const double sparseStop = mpi::Time();
+
+            double localError = 0;
+            for( int iLocal=0; iLocal<localHeight; ++iLocal )
+                if( firstLocalRow+iLocal >= N-sparseRows )
+                    localError = 
+                        std::max
+                        ( localError, 
+                          Abs(xFull.GetLocal(iLocal,0)-
+                              xSparse.GetLocal(iLocal,0)) );
+            const double error = mpi::AllReduce( localError, mpi::MAX, comm );
+            if( commRank == 0 )
+                std::cout << "done, " << sparseStop-sparseStart 
+                          << " seconds (vs. " << sparseStart-fullStart 
+                          << " seconds for a full solve)\n"
+                          << "max error in requested rows = " << error << "\n"
+                          << std::endl;
+        }
     }
     catch( std::exception& e ) { ReportException(e); }
 